@@ -151,6 +151,8 @@ static const Buttonbind buttonbinds[] =
     {DESKTOP_BUTTON,       WM_KEY, Button2,  quit_all,            {0}},
     {CLIENT_WIN,           WM_KEY, Button1,  move,                {0}},
     {CLIENT_WIN,          WM_SKEY, Button1,  resize,              {0}},
+    {CLIENT_WIN,          CMD_KEY, Button1,  outline_move,        {0}},
+    {CLIENT_WIN, CMD_KEY|ShiftMask, Button1, outline_resize,      {0}},
     {CLIENT_WIN,           WM_KEY, Button2,  change_place,        {0}},
     {CLIENT_WIN,           WM_KEY, Button3,  swap,                {0}},
     {CLIENT_WIN,                0, Button3,  choose,              {0}},
@@ -212,6 +214,9 @@ static const Buttonbind buttonbinds[] =
     {CLIENT_WIN,                0, Button1,  choose,              {0}},
     {CLIENT_FRAME,              0, Button1,  resize,              {0}},
     {CLIENT_ICON,               0, Button1,  deiconify,           {0}},
+    {ICONBAR,                   0, Button1,  scroll_iconbar,      {.n=0}},
+    {ICONBAR,                   0, Button4,  scroll_iconbar,      {.n=-1}},
+    {ICONBAR,                   0, Button5,  scroll_iconbar,      {.n=1}},
     DESKTOP_BUTTONBIND(0),
     DESKTOP_BUTTONBIND(1),
     DESKTOP_BUTTONBIND(2),
@@ -109,6 +109,12 @@ void button_set_icon(Button *button, Imlib_Image image, const char *icon_name, c
         return;
 }
 
+/* 只解除對映像的引用而不釋放它，因爲映像可能仍被其他按鈕使用 */
+void button_drop_image(Button *button)
+{
+    button->image=NULL;
+}
+
 void button_change_icon(Button *button, Imlib_Image image, const char *icon_name, const char *symbol)
 {
     if(image && image!=button->image)
@@ -25,6 +25,7 @@ void button_del(Widget *widget);
 void button_update_fg(const Widget *widget);
 void button_set_icon(Button *button, Imlib_Image image, const char *icon_name, const char *symbol);
 void button_change_icon(Button *button, Imlib_Image image, const char *icon_name, const char *symbol);
+void button_drop_image(Button *button);
 char *button_get_label(const Button *button);
 void button_set_label(Button *button, const char *label);
 void button_set_align(Button *button, Align_type align);
@@ -0,0 +1,129 @@
+/* *************************************************************************
+ *     child.c：實現回收子進程的相關功能。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#define _GNU_SOURCE // 爲了使用syscall
+
+#include <stdio.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include "misc.h"
+#include "child.h"
+
+/* 每個子進程對應一個pidfd，子進程退出時pidfd變爲可讀，主事件循環據此回收子進
+ * 程。但內核不支持pidfd、pidfd_open失敗（如fd耗盡）的子進程以及從父進程繼承
+ * 的子進程都沒有pidfd，故始終安裝SIGCHLD信號處理函數來回收它們。該函數也可能
+ * 先於主事件循環回收有pidfd的子進程，這時reap_children中的waitpid僅會失敗 */
+typedef struct
+{
+    pid_t pid;
+    int pidfd;
+} Child;
+
+static Child *children=NULL;
+static size_t nchildren=0, children_size=0; // 子進程數量及children的容量
+static bool pidfd_supported=false; // 內核是否支持pidfd_open
+
+static void clear_zombies(int signum);
+static int open_pidfd(pid_t pid);
+static void del_child(size_t i);
+
+void init_child_reaper(void)
+{
+    int fd=open_pidfd(getpid());
+
+    if(fd >= 0)
+        close(fd), pidfd_supported=true;
+    if(signal(SIGCHLD, clear_zombies) == SIG_ERR)
+        perror(_("不能安裝SIGCHLD信號處理函數"));
+    clear_zombies(0);
+}
+
+void deinit_child_reaper(void)
+{
+    for(size_t i=0; i<nchildren; i++)
+        close(children[i].pidfd);
+    Free(children);
+    nchildren=children_size=0;
+    clear_zombies(0);
+}
+
+// 信號處理函數：只能調用異步信號安全的函數，且須保留errno
+static void clear_zombies(int signum)
+{
+    int err=errno;
+
+    UNUSED(signum);
+	while(0 < waitpid(-1, NULL, WNOHANG))
+        ;
+    errno=err;
+}
+
+static int open_pidfd(pid_t pid)
+{
+    return syscall(SYS_pidfd_open, pid, 0);
+}
+
+void add_child(pid_t pid)
+{
+    int fd=-1;
+    if(!pidfd_supported || (fd=open_pidfd(pid)) < 0)
+        return;
+
+    if(nchildren == children_size)
+    {
+        children_size = children_size ? 2*children_size : 8;
+        Child *p=realloc(children, children_size*sizeof(Child));
+        if(p == NULL)
+            exit_with_msg(_("錯誤：申請內存失敗"));
+        children=p;
+    }
+    children[nchildren++]=(Child){pid, fd};
+}
+
+size_t get_child_count(void)
+{
+    return nchildren;
+}
+
+// fds應至少有get_child_count()個元素
+void set_child_pollfds(struct pollfd *fds)
+{
+    for(size_t i=0; i<nchildren; i++)
+        fds[i]=(struct pollfd){children[i].pidfd, POLLIN, 0};
+}
+
+// fds應爲poll返回後的set_child_pollfds所設置的n個元素
+void reap_children(const struct pollfd *fds, size_t n)
+{
+    for(size_t i=0; i<n; i++)
+    {
+        if(!fds[i].revents)
+            continue;
+        for(size_t j=0; j<nchildren; j++)
+        {
+            if(children[j].pidfd == fds[i].fd)
+            {
+                waitpid(children[j].pid, NULL, WNOHANG);
+                del_child(j);
+                break;
+            }
+        }
+    }
+}
+
+static void del_child(size_t i)
+{
+    close(children[i].pidfd);
+    children[i]=children[--nchildren];
+}
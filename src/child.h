@@ -0,0 +1,26 @@
+/* *************************************************************************
+ *     child.h：與child.c相應的頭文件。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#ifndef CHILD_H
+#define CHILD_H
+
+#include <stdbool.h>
+#include <poll.h>
+#include <sys/types.h>
+
+void init_child_reaper(void);
+void deinit_child_reaper(void);
+void add_child(pid_t pid);
+size_t get_child_count(void);
+void set_child_pollfds(struct pollfd *fds);
+void reap_children(const struct pollfd *fds, size_t n);
+
+#endif
@@ -9,6 +9,7 @@
  * <http://www.gnu.org/licenses/>。
  * ************************************************************************/
 
+#include <string.h>
 #include <X11/Xft/Xft.h>
 #include "config.h"
 #include "gwm.h"
@@ -20,6 +21,9 @@
 #include "prop.h"
 #include "grab.h"
 #include "rule_cfg.h"
+#include "syncreq.h"
+#include "focus.h"
+#include "xres.h"
 #include "client.h"
 
 static void client_ctor(Client *c, Window win);
@@ -37,9 +41,12 @@ static Client *get_next_layer_client(Layer layer, Area area);
 static void set_default_win_rect(Client *c);
 static void set_client_rect_by_frame(Client *c);
 static Window get_top_win(const Client *c);
+static long get_title_elapsed_ms(const Client *c);
+static void update_client_title(Client *c);
 
 Window top_wins[LAYER_N]; // 窗口疊次序分層參照窗口列表，即分層層頂窗口
 static Client *clients=NULL;
+static size_t title_pending_n=0; // 有尚待更新標題的客戶數
 
 void init_client_list(void)
 {
@@ -67,14 +74,19 @@ static void client_ctor(Client *c, Window win)
     XSelectInput(xinfo.display, win, EnterWindowMask|PropertyChangeMask);
     WIDGET_WIN(c)=win;
     c->title_text=get_title_text(win, "");
+    c->title_hash=get_string_hash(c->title_text);
+    c->title_time=0;
+    c->title_pending=false;
     c->wm_hint=XGetWMHints(xinfo.display, win);
     c->win_type=get_net_wm_win_type(win);
     c->win_state=get_net_wm_state(win);
     c->decorative=has_decoration(c);
     c->follow_maxmin_hint=false;
+    c->outline_mvresize=false;
     c->owner=win_to_client(get_transient_for(WIDGET_WIN(c)));
     c->subgroup_leader = c->owner ? c->owner->subgroup_leader : c;
     c->image=get_win_icon_image(win);
+    set_client_sync_counter(c);
     set_default_win_rect(c);
     create_frame(c);
     widget_set_draggable(WIDGET(c), true);
@@ -153,6 +165,7 @@ static void apply_rules(Client *c)
             if(r->desktop_mask)
                 c->desktop_mask=r->desktop_mask;
             c->follow_maxmin_hint=r->follow_maxmin_hint;
+            c->outline_mvresize=r->outline_mvresize;
         }
     }
 }
@@ -204,11 +217,80 @@ void client_del(Client *c)
 
 static void client_dtor(Client *c)
 {
+    if(c->title_pending)
+        title_pending_n--;
     vXFree(c->class_hint.res_class, c->class_hint.res_name, c->wm_hint);
     Free(c->title_text);
+    unset_client_sync_counter(c);
     frame_del(c->frame), c->frame=NULL;
 }
 
+/* 終端、瀏覽器可能每秒多次修改標題。同一客戶的標題在
+ * cfg->title_update_interval毫秒內最多更新一次，期間的修改合併到間隔結束時
+ * 一併處理；標題文字未變時不重繪 */
+void request_title_update(Client *c)
+{
+    if(c->title_pending)
+        return;
+
+    if(get_title_elapsed_ms(c) >= cfg->title_update_interval)
+        update_client_title(c);
+    else
+        c->title_pending=true, title_pending_n++;
+}
+
+/* 返回距離最早的待定標題更新生效的毫秒數，無待定更新時返回-1 */
+int get_title_update_timeout(void)
+{
+    long timeout=-1;
+
+    if(!title_pending_n)
+        return -1;
+    clients_for_each(c)
+    {
+        if(c->title_pending)
+        {
+            long t=MAX(cfg->title_update_interval-get_title_elapsed_ms(c), 0);
+            if(timeout<0 || t<timeout)
+                timeout=t;
+        }
+    }
+    return timeout;
+}
+
+void handle_title_update_timeout(void)
+{
+    if(!title_pending_n)
+        return;
+    clients_for_each(c)
+        if(c->title_pending && get_title_elapsed_ms(c)>=cfg->title_update_interval)
+            update_client_title(c);
+}
+
+static long get_title_elapsed_ms(const Client *c)
+{
+    return (get_monotonic_us()-c->title_time)/1000;
+}
+
+static void update_client_title(Client *c)
+{
+    char *s=get_title_text(WIDGET_WIN(c), "");
+    uint64_t hash=get_string_hash(s);
+
+    if(c->title_pending)
+        c->title_pending=false, title_pending_n--;
+    if(hash==c->title_hash && strcmp(s, c->title_text)==0)
+    {
+        Free(s);
+        return;
+    }
+
+    Free(c->title_text);
+    c->title_text=s, c->title_hash=hash;
+    c->title_time=get_monotonic_us();
+    frame_change_title(c->frame, s);
+}
+
 /* 當WIDGET_WIN(c)所在的亞組存在模態窗口時，跳過所有亞組窗口 */
 Client *get_next(Client *c)
 {
@@ -443,7 +525,7 @@ void create_layer_wins(void)
 void destroy_layer_wins(void)
 {
     for(size_t i=0; i<LAYER_N; i++)
-        XDestroyWindow(xinfo.display, top_wins[i]);
+        destroy_win(top_wins[i]);
 }
 
 /* 僅在移動窗口、聚焦窗口時或窗口類型、狀態發生變化才有可能需要提升 */
@@ -457,4 +539,5 @@ void raise_client(Client *c)
         wins[i--]=WIDGET_WIN(p->frame);
 
     XRestackWindows(xinfo.display, wins, n+1);
+    ignore_wm_crossing_events();
 }
@@ -12,6 +12,8 @@
 #ifndef CLIENT_H
 #define CLIENT_H
 
+#include <stdint.h>
+#include <X11/extensions/sync.h>
 #include "gwm.h"
 #include "drawable.h"
 #include "ewmh.h"
@@ -24,6 +26,7 @@ typedef struct client_tag // 客戶窗口相關信息
     Frame *frame; // 客戶窗口裝飾
     bool decorative; // 是否裝飾，即顯示窗口標題欄和邊框
     bool follow_maxmin_hint; // 遵從最大和最小尺寸提示的標志
+    bool outline_mvresize; // 以輪廓方式移動和調整窗口尺寸的標志
     int ox, oy, ow, oh; // 分别爲win原來的橫、縱坐標和寬、高
     unsigned int desktop_mask; // 所屬虚拟桌面的掩碼
     Layer layer, olayer; // 客戶窗口當前和原來所在的層
@@ -31,10 +34,16 @@ typedef struct client_tag // 客戶窗口相關信息
     Net_wm_win_type win_type; // win的窗口類型
     Net_wm_state win_state; // win的窗口狀態
     char *title_text; // 標題的文字
+    uint64_t title_hash; // 標題文字的散列值
+    uint64_t title_time; // 最近一次更新標題的時刻（單調時鐘的微秒數）
+    bool title_pending; // 是否有尚待更新的標題
     Imlib_Image image; // 圖標映像
     const char *class_name; // 客戶窗口的程序類型名
     XClassHint class_hint; // 客戶窗口的程序類型特性提示
     XWMHints *wm_hint; // 客戶窗口的窗口管理程序條件特性提示
+    XSyncCounter sync_counter; // 客戶窗口的_NET_WM_SYNC_REQUEST_COUNTER
+    XSyncAlarm sync_alarm; // 監視sync_counter的報警器
+    XSyncValue sync_value; // 最近一次發送給客戶的同步序號
     // 分別爲主窗口節點、亚組組長節點（同屬一個程序實例的客戶構成一個亞組）
     struct client_tag *owner, *subgroup_leader;
     List list;
@@ -77,6 +86,9 @@ int get_clients_n(Layer layer, Area area, bool count_icon, bool count_trans, boo
 bool is_iconic_client(const Client *c);
 Client *win_to_client(Window win);
 void client_del(Client *c);
+void request_title_update(Client *c);
+int get_title_update_timeout(void);
+void handle_title_update_timeout(void);
 Client *get_next(Client *c);
 Client *get_prev(Client *c);
 bool is_place_last_client(Client *c);
@@ -13,6 +13,8 @@
 #include "grab.h"
 #include "focus.h"
 #include "prop.h"
+#include "layout.h"
+#include "trace.h"
 #include "clientop.h"
 
 static void set_frame_rect_by_client(Client *c);
@@ -47,12 +49,14 @@ void manage_exsit_clients(void)
 
 void add_client(Window win)
 {
+    TRACE_BEGIN("add_client", win);
     Client *c=client_new(win);
     set_cursor(win, NO_OP);
     request_layout_update();
     widget_show(WIDGET(c->frame));
     set_net_wm_allowed_actions(WIDGET_WIN(c));
     focus_client(c);
+    TRACE_END("add_client", win);
 }
 
 void remove_client(Client *c)
@@ -71,6 +75,7 @@ void move_resize_client(Client *c, const Delta_rect *d)
 
     int bh=frame_get_titlebar_height(c->frame);
     XMoveResizeWindow(xinfo.display, WIDGET_WIN(c), 0, bh, WIDGET_W(c), WIDGET_H(c));
+    ignore_wm_crossing_events();
 }
 
 static void set_frame_rect_by_client(Client *c)
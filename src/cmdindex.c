@@ -0,0 +1,172 @@
+/* *************************************************************************
+ *     cmdindex.c：實現PATH可執行文件索引的相關功能。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#define _DEFAULT_SOURCE // 爲了使用struct dirent的d_type成員
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/inotify.h>
+#include "misc.h"
+#include "cmdindex.h"
+
+/* 索引是PATH各目錄下文件名的有序數組，以inotify監視這些目錄，目錄內容有變
+ * 化時纔重建索引，補全時只需二分查找前綴 */
+#define CMD_INDEX_WATCH_MASK (IN_CREATE|IN_DELETE|IN_MOVED_FROM|IN_MOVED_TO \
+    |IN_ATTRIB|IN_DELETE_SELF|IN_MOVE_SELF)
+
+static char **cmds=NULL; // 按升序排列且無重複的命令名
+static size_t ncmds=0, cmds_size=0; // 命令名數量及cmds的容量
+static int inotify_fd=-1; // 監視PATH各目錄的inotify文件描述符
+static bool is_stale=true; // 索引是否需要重建
+
+static bool is_cmd_index_stale(void);
+static void rebuild_cmd_index(void);
+static void add_cmds_in_dir(const char *path);
+static void add_cmd(const char *name);
+static void free_cmds(void);
+static int cmp_cmd(const void *p1, const void *p2);
+static size_t find_first_cmd(const char *prefix);
+
+void init_cmd_index(void)
+{
+    is_stale=true;
+}
+
+void deinit_cmd_index(void)
+{
+    free_cmds();
+    if(inotify_fd >= 0)
+        close(inotify_fd), inotify_fd=-1;
+    is_stale=true;
+}
+
+Strings *get_cmd_completions(const char *prefix, size_t nmax)
+{
+    Strings *result=Malloc(sizeof(Strings));
+    size_t len=strlen(prefix);
+
+    LIST_INIT(result);
+    if(is_cmd_index_stale())
+        rebuild_cmd_index();
+    for(size_t i=find_first_cmd(prefix), n=0; i<ncmds && n<nmax
+        && strncmp(cmds[i], prefix, len)==0; i++, n++)
+    {
+        Strings *s=Malloc(sizeof(Strings));
+        s->str=copy_string(cmds[i]);
+        LIST_ADD_TAIL(s, result);
+    }
+
+    return result;
+}
+
+/* 讀盡inotify事件，有任何事件即表示索引已過時。無法使用inotify時，每次都視
+ * 爲過時 */
+static bool is_cmd_index_stale(void)
+{
+    char buf[BUFSIZ];
+
+    if(inotify_fd < 0)
+        return true;
+    while(read(inotify_fd, buf, sizeof(buf)) > 0)
+        is_stale=true;
+
+    return is_stale;
+}
+
+/* 重建索引時亦重建監視，以便跟踪被刪除後又重新創建的目錄 */
+static void rebuild_cmd_index(void)
+{
+    char *paths=getenv("PATH"), *p=NULL, *ps=NULL;
+
+    deinit_cmd_index();
+    if(!paths)
+        return;
+
+    inotify_fd=inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+    ps=copy_string(paths);
+    for(p=strtok(ps, ":"); p; p=strtok(NULL, ":"))
+    {
+        if(inotify_fd >= 0)
+            inotify_add_watch(inotify_fd, p, CMD_INDEX_WATCH_MASK);
+        add_cmds_in_dir(p);
+    }
+    Free(ps);
+
+    qsort(cmds, ncmds, sizeof(char *), cmp_cmd);
+    size_t n=0;
+    for(size_t i=0; i<ncmds; i++) // 去除不同目錄下的同名命令
+    {
+        if(n && strcmp(cmds[n-1], cmds[i])==0)
+            Free(cmds[i]);
+        else
+            cmds[n++]=cmds[i];
+    }
+    ncmds=n;
+    is_stale=false;
+}
+
+static void add_cmds_in_dir(const char *path)
+{
+    DIR *dir=opendir(path);
+
+    if(dir == NULL)
+        return;
+
+    for(struct dirent *d=NULL; (d=readdir(dir));)
+        if(d->d_type!=DT_DIR && strcmp(".", d->d_name) && strcmp("..", d->d_name))
+            add_cmd(d->d_name);
+    closedir(dir);
+}
+
+static void add_cmd(const char *name)
+{
+    if(ncmds == cmds_size)
+    {
+        cmds_size = cmds_size ? 2*cmds_size : 1024;
+        char **p=realloc(cmds, cmds_size*sizeof(char *));
+        if(p == NULL)
+            exit_with_msg(_("錯誤：申請內存失敗"));
+        cmds=p;
+    }
+    cmds[ncmds++]=copy_string(name);
+}
+
+static void free_cmds(void)
+{
+    for(size_t i=0; i<ncmds; i++)
+        free(cmds[i]);
+    Free(cmds);
+    ncmds=cmds_size=0;
+}
+
+static int cmp_cmd(const void *p1, const void *p2)
+{
+    return strcmp(*(char *const *)p1, *(char *const *)p2);
+}
+
+// 二分查找首個不小於prefix的命令名的下標
+static size_t find_first_cmd(const char *prefix)
+{
+    size_t lo=0, hi=ncmds;
+
+    while(lo < hi)
+    {
+        size_t mid=lo+(hi-lo)/2;
+        if(strcmp(cmds[mid], prefix) < 0)
+            lo=mid+1;
+        else
+            hi=mid;
+    }
+
+    return lo;
+}
@@ -0,0 +1,678 @@
+/* *************************************************************************
+ *     compositor.c：實現基於損壞區域跟蹤的內置XRender合成器。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include <X11/extensions/Xcomposite.h>
+#include <X11/extensions/Xdamage.h>
+#include <X11/extensions/Xrender.h>
+#include <X11/extensions/shape.h>
+#include "client.h"
+#include "color.h"
+#include "ewmh.h"
+#include "misc.h"
+#include "prop.h"
+#include "wallpaper.h"
+#include "xres.h"
+#include "compositor.h"
+
+/* 把根窗口的所有子窗口重定向到屏外，只在空閒時把累積的損壞區域重繪到合成
+ * 覆蓋窗口上。重繪分兩趟：先自上而下以PictOpSrc繪製不透明窗口，每畫一個就從
+ * 裁剪區域中減去它，使被遮擋的部分不再繪製；再畫根窗口背景，最後自下而上混合
+ * 半透明窗口。這樣在沒有GPU的機器上，每次重繪的開銷只與損壞區域的面積和其上的
+ * 半透明窗口數有關。最頂層的不透明窗口佔滿屏幕時取消重定向，讓它直接顯示 */
+#define OPAQUE 0xffffffffUL // _NET_WM_WINDOW_OPACITY的完全不透明值
+#define COMP_WIN_W(cw) ((cw)->w+2*(cw)->bw) // 含邊框的寬度
+#define COMP_WIN_H(cw) ((cw)->h+2*(cw)->bw) // 含邊框的高度
+
+typedef struct comp_win_tag // 受合成的頂層窗口
+{
+    struct comp_win_tag *next; // 疊次更低的窗口
+    struct comp_win_tag *higher_trans; // 本次重繪中疊次更高的半透明窗口
+    Window win;
+    int x, y, w, h, bw; // 坐標、尺寸及邊框寬度
+    bool viewable, input_only, argb; // 是否可見、是否僅供輸入、是否帶alpha通道
+    unsigned long opacity; // 不透明度
+    XRenderPictFormat *format; // 窗口內容的像素格式
+    Damage damage; // 損壞對象
+    Pixmap pixmap; // 重定向後窗口內容所在的pixmap
+    Picture pict, alpha; // 窗口內容及不透明度蒙版
+    XserverRegion clip; // 本次重繪中未被上方不透明窗口遮擋的區域
+} Comp_win;
+
+typedef struct // 合成器狀態
+{
+    bool running, redirected; // 是否在運行、是否已重定向子窗口
+    int damage_event; // 損壞通知事件的類型
+    Window owner, overlay; // _NET_WM_CM_Sn選擇區的所有者、合成覆蓋窗口
+    Pixmap buffer_pixmap; // 後台緩衝區
+    Picture target, buffer, root_tile; // 覆蓋窗口、後台緩衝區及根窗口背景
+    XserverRegion damage; // 尚待重繪的區域
+    Comp_win *wins; // 按疊次從高到低排列的頂層窗口
+    Atom opacity_atom, root_pmap_atom;
+} Compositor;
+
+static Compositor comp;
+
+static bool query_extensions(void);
+static bool own_cm_selection(void);
+static void create_overlay(void);
+static void add_all_wins(void);
+static void free_all_wins(void);
+static Comp_win *add_win(Window win, Window above);
+static void del_win(Comp_win *cw, bool gone);
+static Comp_win *find_win(Window win);
+static void unlink_win(Comp_win *cw);
+static void restack_win(Comp_win *cw, Window above);
+static void handle_damage_notify(const XDamageNotifyEvent *e);
+static void handle_create_notify(const XCreateWindowEvent *e);
+static void handle_config_notify(const XConfigureEvent *e);
+static void handle_map_notify(const XMapEvent *e);
+static void handle_unmap_notify(const XUnmapEvent *e);
+static void handle_destroy_notify(const XDestroyWindowEvent *e);
+static void handle_reparent_notify(const XReparentEvent *e);
+static void handle_circulate_notify(const XCirculateEvent *e);
+static void handle_property_notify(const XPropertyEvent *e);
+static unsigned long get_win_opacity(Window win);
+static bool is_opaque(const Comp_win *cw);
+static bool is_paintable(const Comp_win *cw);
+static bool update_redirection(void);
+static Comp_win *get_top_paintable_win(void);
+static bool covers_screen(const Comp_win *cw);
+static bool get_win_picture(Comp_win *cw);
+static void free_win_picture(Comp_win *cw);
+static Picture get_alpha_picture(Comp_win *cw);
+static void paint_root(void);
+static XserverRegion get_win_extents(const Comp_win *cw);
+static void add_damage(XserverRegion region);
+static void damage_win(const Comp_win *cw);
+static void damage_screen(void);
+
+bool start_compositor(void)
+{
+    if(comp.running)
+        return true;
+    if(have_compositor())
+    {
+        fprintf(stderr, _("錯誤：已經有合成器在運行！\n"));
+        return false;
+    }
+    if(!query_extensions())
+    {
+        fprintf(stderr, _("錯誤：X服務器不支持內置合成器所需的Composite、Damage、Render或XFixes擴展！\n"));
+        return false;
+    }
+    if(!own_cm_selection())
+        return false;
+    update_compositor_owner(comp.owner); // 不必等待所有者變化的通知
+
+    comp.opacity_atom=XInternAtom(xinfo.display, "_NET_WM_WINDOW_OPACITY", False);
+    comp.root_pmap_atom=XInternAtom(xinfo.display, "_XROOTPMAP_ID", False);
+    XGrabServer(xinfo.display);
+    XCompositeRedirectSubwindows(xinfo.display, xinfo.root_win, CompositeRedirectManual);
+    comp.redirected=true;
+    create_overlay();
+    add_all_wins();
+    XUngrabServer(xinfo.display);
+    comp.running=true;
+    update_wallpaper_mode();
+    damage_screen();
+
+    return true;
+}
+
+static bool query_extensions(void)
+{
+    Display *d=xinfo.display;
+    int event, error, major=0, minor=3;
+
+    if( !XCompositeQueryExtension(d, &event, &error)
+        || !XCompositeQueryVersion(d, &major, &minor)
+        || (major==0 && minor<3)) // 合成覆蓋窗口始於0.3版
+        return false;
+
+    major=2, minor=0;
+    if( !XFixesQueryExtension(d, &event, &error)
+        || !XFixesQueryVersion(d, &major, &minor) || major<2)
+        return false;
+
+    major=0, minor=10;
+    if( !XRenderQueryExtension(d, &event, &error)
+        || !XRenderQueryVersion(d, &major, &minor)
+        || (major==0 && minor<10)) // 純色填充圖片始於0.10版
+        return false;
+
+    major=1, minor=1;
+    return XDamageQueryExtension(d, &comp.damage_event, &error)
+        && XDamageQueryVersion(d, &major, &minor) && major>=1;
+}
+
+static bool own_cm_selection(void)
+{
+    Atom atom=get_net_wm_cm_atom();
+
+    comp.owner=XCreateSimpleWindow(xinfo.display, xinfo.root_win,
+        -1, -1, 1, 1, 0, 0, 0);
+    XSetSelectionOwner(xinfo.display, atom, comp.owner, CurrentTime);
+    if(XGetSelectionOwner(xinfo.display, atom) == comp.owner)
+        return true;
+
+    XDestroyWindow(xinfo.display, comp.owner), comp.owner=None;
+    return false;
+}
+
+/* 覆蓋窗口位於所有窗口之上，須把其輸入區域設爲空，以免擋住定位器事件 */
+static void create_overlay(void)
+{
+    Display *d=xinfo.display;
+    Visual *visual=DefaultVisual(d, xinfo.screen);
+    XRenderPictFormat *format=XRenderFindVisualFormat(d, visual);
+    XRenderPictureAttributes pa={.subwindow_mode=IncludeInferiors};
+    XserverRegion empty=XFixesCreateRegion(d, NULL, 0);
+    int w=xinfo.screen_width, h=xinfo.screen_height;
+
+    comp.overlay=XCompositeGetOverlayWindow(d, xinfo.root_win);
+    XFixesSetWindowShapeRegion(d, comp.overlay, ShapeInput, 0, 0, empty);
+    XFixesDestroyRegion(d, empty);
+    comp.target=XRenderCreatePicture(d, comp.overlay, format, CPSubwindowMode, &pa);
+    comp.buffer_pixmap=create_pixmap(xinfo.root_win, w, h,
+        DefaultDepth(d, xinfo.screen), "compositor");
+    comp.buffer=XRenderCreatePicture(d, comp.buffer_pixmap, format, 0, NULL);
+}
+
+static void add_all_wins(void)
+{
+    Window root, parent, *child=NULL, below=None;
+    unsigned int n;
+
+    if(!XQueryTree(xinfo.display, xinfo.root_win, &root, &parent, &child, &n))
+        return;
+    // XQueryTree按疊次從低到高返回子窗口
+    for(unsigned int i=0; i<n; i++)
+        if(add_win(child[i], below))
+            below=child[i];
+    XFree(child);
+}
+
+void stop_compositor(void)
+{
+    Display *d=xinfo.display;
+
+    if(!comp.running)
+        return;
+
+    free_all_wins();
+    if(comp.redirected)
+        XCompositeUnredirectSubwindows(d, xinfo.root_win, CompositeRedirectManual);
+    if(comp.root_tile)
+        XRenderFreePicture(d, comp.root_tile);
+    if(comp.damage)
+        XFixesDestroyRegion(d, comp.damage);
+    XRenderFreePicture(d, comp.buffer);
+    free_pixmap(comp.buffer_pixmap);
+    XRenderFreePicture(d, comp.target);
+    XCompositeReleaseOverlayWindow(d, xinfo.root_win);
+    XDestroyWindow(d, comp.owner); // 同時放棄選擇區所有權
+    comp=(Compositor){0};
+    update_compositor_owner(None); // 與start_compositor相應，不必等待通知
+    update_wallpaper_mode();
+}
+
+static void free_all_wins(void)
+{
+    while(comp.wins)
+        del_win(comp.wins, false);
+}
+
+bool is_compositor_running(void)
+{
+    return comp.running;
+}
+
+/* 新窗口置於above之上，above爲None時置於最底層 */
+static Comp_win *add_win(Window win, Window above)
+{
+    XWindowAttributes a;
+
+    if( win==comp.overlay || win==comp.owner
+        || !XGetWindowAttributes(xinfo.display, win, &a))
+        return NULL;
+
+    Comp_win *cw=Malloc(sizeof(Comp_win));
+    *cw=(Comp_win){.win=win, .x=a.x, .y=a.y, .w=a.width, .h=a.height,
+        .bw=a.border_width, .viewable=(a.map_state==IsViewable),
+        .input_only=(a.class==InputOnly), .opacity=OPAQUE};
+    if(!cw->input_only)
+    {
+        cw->format=XRenderFindVisualFormat(xinfo.display, a.visual);
+        cw->argb=(cw->format && cw->format->type==PictTypeDirect
+            && cw->format->direct.alphaMask);
+        cw->opacity=get_win_opacity(win);
+        cw->damage=XDamageCreate(xinfo.display, win, XDamageReportNonEmpty);
+    }
+    restack_win(cw, above);
+    damage_win(cw);
+
+    return cw;
+}
+
+/* gone表示窗口已被銷毀，其損壞對象亦已隨之銷毀 */
+static void del_win(Comp_win *cw, bool gone)
+{
+    damage_win(cw);
+    free_win_picture(cw);
+    if(cw->alpha)
+        XRenderFreePicture(xinfo.display, cw->alpha);
+    if(cw->damage && !gone)
+        XDamageDestroy(xinfo.display, cw->damage);
+    unlink_win(cw);
+    Free(cw);
+}
+
+static Comp_win *find_win(Window win)
+{
+    for(Comp_win *cw=comp.wins; cw; cw=cw->next)
+        if(cw->win == win)
+            return cw;
+    return NULL;
+}
+
+static void unlink_win(Comp_win *cw)
+{
+    for(Comp_win **p=&comp.wins; *p; p=&(*p)->next)
+    {
+        if(*p == cw)
+        {
+            *p=cw->next;
+            break;
+        }
+    }
+}
+
+/* 把cw移到above之上，above爲None時移到最底層，找不到above時移到最頂層 */
+static void restack_win(Comp_win *cw, Window above)
+{
+    Comp_win **p=&comp.wins;
+
+    unlink_win(cw);
+    if(above == None)
+        while(*p)
+            p=&(*p)->next;
+    else
+    {
+        for(; *p && (*p)->win!=above; p=&(*p)->next)
+            ;
+        if(!*p)
+            p=&comp.wins;
+    }
+    cw->next=*p;
+    *p=cw;
+}
+
+void handle_compositor_event(const XEvent *e)
+{
+    if(!comp.running)
+        return;
+
+    if(e->type == comp.damage_event+XDamageNotify)
+    {
+        handle_damage_notify((const XDamageNotifyEvent *)e);
+        return;
+    }
+    switch(e->type)
+    {
+        case CreateNotify:    handle_create_notify(&e->xcreatewindow); break;
+        case ConfigureNotify: handle_config_notify(&e->xconfigure); break;
+        case MapNotify:       handle_map_notify(&e->xmap); break;
+        case UnmapNotify:     handle_unmap_notify(&e->xunmap); break;
+        case DestroyNotify:   handle_destroy_notify(&e->xdestroywindow); break;
+        case ReparentNotify:  handle_reparent_notify(&e->xreparent); break;
+        case CirculateNotify: handle_circulate_notify(&e->xcirculate); break;
+        case PropertyNotify:  handle_property_notify(&e->xproperty); break;
+        default: break;
+    }
+}
+
+/* 取出損壞對象中累積的區域，轉換爲屏幕坐標後加入待重繪區域 */
+static void handle_damage_notify(const XDamageNotifyEvent *e)
+{
+    Comp_win *cw=find_win(e->drawable);
+
+    if(!cw)
+    {
+        XDamageSubtract(xinfo.display, e->damage, None, None);
+        return;
+    }
+
+    XserverRegion parts=XFixesCreateRegion(xinfo.display, NULL, 0);
+    XDamageSubtract(xinfo.display, cw->damage, None, parts);
+    if(!cw->viewable)
+    {
+        XFixesDestroyRegion(xinfo.display, parts);
+        return;
+    }
+    XFixesTranslateRegion(xinfo.display, parts, cw->x+cw->bw, cw->y+cw->bw);
+    add_damage(parts);
+}
+
+static void handle_create_notify(const XCreateWindowEvent *e)
+{
+    if(e->parent==xinfo.root_win && !find_win(e->window))
+        add_win(e->window, comp.wins ? comp.wins->win : None);
+}
+
+static void handle_config_notify(const XConfigureEvent *e)
+{
+    Comp_win *cw=NULL;
+
+    if(e->event!=xinfo.root_win || !(cw=find_win(e->window)))
+        return;
+
+    damage_win(cw);
+    if(cw->w!=e->width || cw->h!=e->height || cw->bw!=e->border_width)
+        free_win_picture(cw);
+    cw->x=e->x, cw->y=e->y, cw->w=e->width, cw->h=e->height;
+    cw->bw=e->border_width;
+    restack_win(cw, e->above);
+    damage_win(cw);
+}
+
+/* 窗口每次映射後都要重新獲取其內容所在的pixmap */
+static void handle_map_notify(const XMapEvent *e)
+{
+    Comp_win *cw=NULL;
+
+    if(e->event!=xinfo.root_win || !(cw=find_win(e->window)))
+        return;
+
+    free_win_picture(cw);
+    cw->viewable=true;
+    damage_win(cw);
+}
+
+static void handle_unmap_notify(const XUnmapEvent *e)
+{
+    Comp_win *cw=NULL;
+
+    if(e->event!=xinfo.root_win || !(cw=find_win(e->window)))
+        return;
+
+    damage_win(cw);
+    cw->viewable=false;
+    free_win_picture(cw);
+}
+
+static void handle_destroy_notify(const XDestroyWindowEvent *e)
+{
+    Comp_win *cw=NULL;
+
+    if(e->event==xinfo.root_win && (cw=find_win(e->window)))
+        del_win(cw, true);
+}
+
+/* 客戶窗口被重設父窗口到框架中後不再是頂層窗口，而由其框架代爲合成 */
+static void handle_reparent_notify(const XReparentEvent *e)
+{
+    Comp_win *cw=find_win(e->window);
+
+    if(e->parent == xinfo.root_win)
+    {
+        if(!cw)
+            add_win(e->window, comp.wins ? comp.wins->win : None);
+    }
+    else if(cw)
+        del_win(cw, false);
+}
+
+static void handle_circulate_notify(const XCirculateEvent *e)
+{
+    Comp_win *cw=NULL;
+
+    if(e->event!=xinfo.root_win || !(cw=find_win(e->window)))
+        return;
+
+    restack_win(cw, e->place==PlaceOnTop && comp.wins ? comp.wins->win : None);
+    damage_win(cw);
+}
+
+/* 框架沒有複製客戶窗口特性時，客戶窗口的不透明度變化要轉到其框架上 */
+static void handle_property_notify(const XPropertyEvent *e)
+{
+    Comp_win *cw=NULL;
+
+    if(e->atom == comp.root_pmap_atom && e->window == xinfo.root_win)
+    {
+        if(comp.root_tile)
+            XRenderFreePicture(xinfo.display, comp.root_tile), comp.root_tile=None;
+        damage_screen();
+    }
+    else if(e->atom == comp.opacity_atom)
+    {
+        Client *c=win_to_client(e->window);
+        if(!(cw=find_win(c ? WIDGET_WIN(c->frame) : e->window)))
+            return;
+        cw->opacity=get_win_opacity(cw->win);
+        if(cw->alpha)
+            XRenderFreePicture(xinfo.display, cw->alpha), cw->alpha=None;
+        damage_win(cw);
+    }
+}
+
+static unsigned long get_win_opacity(Window win)
+{
+    long opacity=get_cardinal_prop(win, comp.opacity_atom, -1);
+
+    if(opacity == -1)
+    {
+        Client *c=win_to_client(win);
+        if(c && win==WIDGET_WIN(c->frame))
+            opacity=get_cardinal_prop(WIDGET_WIN(c), comp.opacity_atom, -1);
+    }
+    return opacity==-1 ? OPAQUE : (unsigned long)opacity & OPAQUE;
+}
+
+static bool is_opaque(const Comp_win *cw)
+{
+    return !cw->argb && cw->opacity==OPAQUE;
+}
+
+static bool is_paintable(const Comp_win *cw)
+{
+    return cw->viewable && !cw->input_only && cw->opacity
+        && cw->x+COMP_WIN_W(cw)>0 && cw->y+COMP_WIN_H(cw)>0
+        && cw->x<xinfo.screen_width && cw->y<xinfo.screen_height;
+}
+
+void paint_compositor(void)
+{
+    Display *d=xinfo.display;
+    XserverRegion damage=comp.damage, region;
+    Comp_win *trans=NULL;
+
+    if(!comp.running || !damage)
+        return;
+
+    comp.damage=None;
+    if(!update_redirection())
+    {
+        XFixesDestroyRegion(d, damage);
+        return;
+    }
+
+    region=XFixesCreateRegion(d, NULL, 0);
+    XFixesCopyRegion(d, region, damage);
+    for(Comp_win *cw=comp.wins; cw; cw=cw->next)
+    {
+        if(!is_paintable(cw) || (!cw->pict && !get_win_picture(cw)))
+            continue;
+        if(is_opaque(cw))
+        {
+            XserverRegion extents=get_win_extents(cw);
+            XFixesSetPictureClipRegion(d, comp.buffer, 0, 0, region);
+            XRenderComposite(d, PictOpSrc, cw->pict, None, comp.buffer, 0, 0,
+                0, 0, cw->x, cw->y, COMP_WIN_W(cw), COMP_WIN_H(cw));
+            XFixesSubtractRegion(d, region, region, extents);
+            XFixesDestroyRegion(d, extents);
+        }
+        else
+        {
+            cw->clip=XFixesCreateRegion(d, NULL, 0);
+            XFixesCopyRegion(d, cw->clip, region);
+            cw->higher_trans=trans, trans=cw;
+        }
+    }
+
+    XFixesSetPictureClipRegion(d, comp.buffer, 0, 0, region);
+    paint_root();
+    XFixesDestroyRegion(d, region);
+
+    for(Comp_win *cw=trans; cw; cw=cw->higher_trans)
+    {
+        XFixesSetPictureClipRegion(d, comp.buffer, 0, 0, cw->clip);
+        XRenderComposite(d, PictOpOver, cw->pict, get_alpha_picture(cw),
+            comp.buffer, 0, 0, 0, 0, cw->x, cw->y, COMP_WIN_W(cw), COMP_WIN_H(cw));
+        XFixesDestroyRegion(d, cw->clip), cw->clip=None;
+    }
+
+    XFixesSetPictureClipRegion(d, comp.buffer, 0, 0, None);
+    XFixesSetPictureClipRegion(d, comp.target, 0, 0, damage);
+    XRenderComposite(d, PictOpSrc, comp.buffer, None, comp.target, 0, 0, 0, 0,
+        0, 0, xinfo.screen_width, xinfo.screen_height);
+    XFixesDestroyRegion(d, damage);
+}
+
+/* 返回是否仍處於重定向狀態。最頂層窗口佔滿屏幕時取消重定向並隱藏覆蓋窗口，
+ * 使全屏程序的繪製不經合成直接上屏 */
+static bool update_redirection(void)
+{
+    Display *d=xinfo.display;
+    bool fullscreen=covers_screen(get_top_paintable_win());
+
+    if(fullscreen && comp.redirected)
+    {
+        for(Comp_win *cw=comp.wins; cw; cw=cw->next)
+            free_win_picture(cw);
+        XUnmapWindow(d, comp.overlay);
+        XCompositeUnredirectSubwindows(d, xinfo.root_win, CompositeRedirectManual);
+        comp.redirected=false;
+    }
+    else if(!fullscreen && !comp.redirected)
+    {
+        XCompositeRedirectSubwindows(d, xinfo.root_win, CompositeRedirectManual);
+        XMapWindow(d, comp.overlay);
+        comp.redirected=true;
+        damage_screen();
+    }
+    return comp.redirected;
+}
+
+static Comp_win *get_top_paintable_win(void)
+{
+    for(Comp_win *cw=comp.wins; cw; cw=cw->next)
+        if(is_paintable(cw))
+            return cw;
+    return NULL;
+}
+
+static bool covers_screen(const Comp_win *cw)
+{
+    return cw && is_opaque(cw) && cw->x<=0 && cw->y<=0
+        && cw->x+COMP_WIN_W(cw)>=xinfo.screen_width
+        && cw->y+COMP_WIN_H(cw)>=xinfo.screen_height;
+}
+
+static bool get_win_picture(Comp_win *cw)
+{
+    XRenderPictureAttributes pa={.subwindow_mode=IncludeInferiors};
+
+    if(!cw->format)
+        return false;
+    cw->pixmap=XCompositeNameWindowPixmap(xinfo.display, cw->win);
+    reg_xres(XRES_PIXMAP, cw->pixmap, "compositor",
+        (size_t)COMP_WIN_W(cw)*COMP_WIN_H(cw)*4);
+    cw->pict=XRenderCreatePicture(xinfo.display, cw->pixmap, cw->format,
+        CPSubwindowMode, &pa);
+    return true;
+}
+
+static void free_win_picture(Comp_win *cw)
+{
+    if(cw->pict)
+        XRenderFreePicture(xinfo.display, cw->pict), cw->pict=None;
+    if(cw->pixmap)
+        free_pixmap(cw->pixmap), cw->pixmap=None;
+}
+
+/* 不透明度蒙版是一個重複填充的純色圖片，完全不透明時不需要蒙版 */
+static Picture get_alpha_picture(Comp_win *cw)
+{
+    if(cw->opacity==OPAQUE || cw->alpha)
+        return cw->alpha;
+
+    XRenderColor c={.alpha=cw->opacity>>16};
+    return cw->alpha=XRenderCreateSolidFill(xinfo.display, &c);
+}
+
+/* 優先使用_XROOTPMAP_ID所指的壁紙，沒有壁紙時使用根窗口的純色 */
+static void paint_root(void)
+{
+    Display *d=xinfo.display;
+
+    if(!comp.root_tile)
+    {
+        Pixmap pixmap=get_pixmap_prop(xinfo.root_win, comp.root_pmap_atom);
+        if(pixmap)
+        {
+            Visual *visual=DefaultVisual(d, xinfo.screen);
+            XRenderPictureAttributes pa={.repeat=True};
+            comp.root_tile=XRenderCreatePicture(d, pixmap,
+                XRenderFindVisualFormat(d, visual), CPRepeat, &pa);
+        }
+        else
+        {
+            unsigned long color=get_root_color();
+            XRenderColor c={.red=(color>>16 & 0xff)*0x101,
+                .green=(color>>8 & 0xff)*0x101, .blue=(color & 0xff)*0x101,
+                .alpha=0xffff};
+            comp.root_tile=XRenderCreateSolidFill(d, &c);
+        }
+    }
+    XRenderComposite(d, PictOpSrc, comp.root_tile, None, comp.buffer, 0, 0,
+        0, 0, 0, 0, xinfo.screen_width, xinfo.screen_height);
+}
+
+static XserverRegion get_win_extents(const Comp_win *cw)
+{
+    XRectangle r={cw->x, cw->y, COMP_WIN_W(cw), COMP_WIN_H(cw)};
+    return XFixesCreateRegion(xinfo.display, &r, 1);
+}
+
+/* 把region併入待重繪區域，region此後歸合成器所有 */
+static void add_damage(XserverRegion region)
+{
+    if(!comp.damage)
+        comp.damage=region;
+    else
+    {
+        XFixesUnionRegion(xinfo.display, comp.damage, comp.damage, region);
+        XFixesDestroyRegion(xinfo.display, region);
+    }
+}
+
+static void damage_win(const Comp_win *cw)
+{
+    if(is_paintable(cw))
+        add_damage(get_win_extents(cw));
+}
+
+static void damage_screen(void)
+{
+    XRectangle r={0, 0, xinfo.screen_width, xinfo.screen_height};
+    add_damage(XFixesCreateRegion(xinfo.display, &r, 1));
+}
@@ -206,11 +206,16 @@ static void config_misc(void)
     cfg->set_frame_prop=false;
     cfg->show_taskbar=true;
     cfg->taskbar_on_top=false;
+    cfg->builtin_compositor=false;
+    cfg->event_stats=false;
     cfg->focus_mode=CLICK_FOCUS;
     cfg->default_layout=TILE;
     cfg->screen_saver_time_out=1800;
     cfg->screen_saver_interval=1800;
     cfg->hover_time=300;
+    cfg->title_update_interval=16;
+    cfg->enter_focus_delay=50;
+    cfg->sync_request_timeout=100;
     cfg->default_cur_desktop=0;
     cfg->default_main_area_n=1;
     cfg->act_center_col=4;
@@ -222,10 +227,15 @@ static void config_misc(void)
     cfg->screenshot_path="~";
     cfg->screenshot_format="png";
     cfg->wallpaper_paths="/usr/share/backgrounds/fedora-workstation:/usr/share/wallpapers";
+    cfg->wallpaper_search_depth=8;
+    cfg->wallpaper_cache_path=NULL;
+    cfg->wallpaper_cache_max=8;
     cfg->wallpaper_filename="/usr/share/backgrounds/gwm.png";
     cfg->cmd_entry_hint=_("請輸入命令，然後按回車執行");
     cfg->color_entry_hint=_("請輸入系統界面主色調的顏色名（支持英文顏色名和十六进制顏色名），然後按回車執行");
     cfg->compositor="picom";
+    cfg->trace_path=NULL;
+    cfg->ipc_socket=NULL;
 }
 
 /* =========================== 用戶配置項結束 =========================== */ 
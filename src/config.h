@@ -27,6 +27,8 @@ typedef struct
 {
     bool set_frame_prop; // true表示把窗口特性復制到窗口框架（代價是每個窗口可能要多消耗幾十到幾百KB內存），false表示不復制
     bool show_taskbar, taskbar_on_top; // 是否顯示任務欄、是否在屏幕頂部顯示
+    bool builtin_compositor; // true表示使用內置合成器並在gwm啓動時開啓它，false表示由合成器按鈕啓動cfg->compositor所指的外部合成器
+    bool event_stats; // 是否統計各類事件的處理耗時及X請求數。開啓後可向gwm發送SIGUSR1信號，使其把統計結果輸出至標準錯誤
     Focus_mode focus_mode; // 聚焦模式
     Layout default_layout; // 默認的窗口布局模式
 
@@ -52,6 +54,9 @@ typedef struct
     unsigned int default_cur_desktop; // 默認的當前桌面
     unsigned int cursor_shape[POINTER_ACT_N]; // 定位器相關的光標字體
     int hover_time; // 定位器懸停的判定時間界限，單位爲毫秒
+    int title_update_interval; // 同一窗口的標題兩次更新的最短間隔，單位爲毫秒。期間的標題修改合併到間隔結束時一併處理。當值爲0時表示不限制。
+    int enter_focus_delay; // 進入窗口即聚焦的模式下，定位器在窗口內停留多久才聚焦，單位爲毫秒。當值爲0時表示立即聚焦。
+    int sync_request_timeout; // 交互式調整窗口尺寸時等待客戶重繪的最長時間，單位爲毫秒。當值爲0時表示不使用_NET_WM_SYNC_REQUEST協議。
 
     double font_pad_ratio; // 文字與構件邊緣的間距與字體高度的比值
     double default_main_area_ratio; // 默認的主區域比例
@@ -63,6 +68,9 @@ typedef struct
     const char *screenshot_path; // 屏幕截圖的文件保存路徑，請自行確保路徑存在
     const char *screenshot_format; // 屏幕截圖的文件保存格式
     const char *wallpaper_paths; // 壁紙目錄列表，如取消此宏定义或目录为空或不能访问，则切换绝壁时使用纯色
+    int wallpaper_search_depth; // 在壁紙目錄下查找壁紙時遞歸進入子目錄的最大層數，負數表示不限
+    const char *wallpaper_cache_path; // 存放已縮放至屏幕尺寸的壁紙的緩存目錄，NULL表示不使用緩存。4K屏幕下每個緩存文件約33MB
+    int wallpaper_cache_max; // 壁紙緩存文件的最大數量，超出時刪除最久未用的緩存文件
     const char *wallpaper_filename; // 壁紙文件名。若刪除本行或文件不能訪問，則使用純色背景
     const char *main_color_name; // 界面主色調
     const char *tooltip[WIDGET_N]; // 构件提示
@@ -72,6 +80,8 @@ typedef struct
     const char *cmd_entry_hint; // 運行輸入框的提示文字
     const char *color_entry_hint; // 颜色輸入框的提示文字
     const char *compositor; // 合成管理器命令
+    const char *trace_path; // 跟蹤記錄的輸出文件，NULL表示不跟蹤。開啓後可向gwm發送SIGUSR2信號，使其把跟蹤記錄以Chrome跟蹤格式寫入此文件，退出時亦會寫入
+    const char *ipc_socket; // IPC套接字的路徑，NULL表示使用默認路徑（$XDG_RUNTIME_DIR/gwm顯示名.sock），空字符串表示不開啓IPC。其路徑經由環境變量GWM_SOCKET傳給子進程
 } Config;
 
 extern Config *cfg; // 窗口管理器配置
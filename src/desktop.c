@@ -12,9 +12,11 @@
 #include "misc.h"
 #include "config.h"
 #include "prop.h"
+#include "layout.h"
 #include "focus.h"
 #include "taskbar.h"
 #include "widget.h"
+#include "trace.h"
 #include "desktop.h"
 
 typedef enum op_type_tag { MOVE_TO_N, CHANGE_TO_N, ATTACH_TO_N, ATTACH_TO_ALL } Op_type;
@@ -42,6 +44,7 @@ void focus_desktop_n(unsigned int n)
     if(n==~0U || n==get_net_current_desktop())
         return;
 
+    TRACE_BEGIN("focus_desktop_n", None);
     hide_cur_desktop_clients();
     set_net_current_desktop(n);
     request_layout_update();
@@ -49,6 +52,8 @@ void focus_desktop_n(unsigned int n)
     show_cur_desktop_clients();
     Client *c=get_cur_focus_client();
     focus_client(is_exist_client(c) ? c : NULL);
+    ignore_wm_crossing_events();
+    TRACE_END("focus_desktop_n", None);
 }
 
 static void hide_cur_desktop_clients(void)
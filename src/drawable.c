@@ -9,10 +9,8 @@
  * <http://www.gnu.org/licenses/>。
  * ************************************************************************/
 
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 #include <Imlib2.h>
 #include <X11/Xatom.h>
 #include "gwm.h"
@@ -21,10 +19,12 @@
 #include "ewmh.h"
 #include "icccm.h"
 #include "misc.h"
+#include "xres.h"
 #include "drawable.h"
 
 static Pixmap create_pixmap_with_color(Drawable d, unsigned long color);
 static void change_prop_for_root_bg(Pixmap pixmap);
+static const Atom *get_root_bg_atoms(void);
 
 bool is_pointer_on_win(Window win)
 {
@@ -48,31 +48,6 @@ bool is_on_screen(int x, int y, int w, int h)
     return labs(2*x+wl-sw)<wl+sw && labs(2*y+hl-sh)<hl+sh;
 }
 
-void print_area(Drawable d, int x, int y, int w, int h)
-{
-    imlib_context_set_drawable(d);
-    Imlib_Image image=imlib_create_image_from_drawable(None, x, y, w, h, 0);
-
-    if(!image)
-        return;
-
-    time_t timer=time(NULL), err=-1;
-    char name[FILENAME_MAX];
-
-    if(cfg->screenshot_path[0] == '~')
-        sprintf(name, "%s%s/gwm-", getenv("HOME"), cfg->screenshot_path+1);
-    else
-        sprintf(name, "%s/gwm-", cfg->screenshot_path);
-    if(timer != err)
-        strftime(name+strlen(name), FILENAME_MAX, "%Y_%m_%d_%H_%M_%S", localtime(&timer));
-    set_visual_for_imlib(d);
-    imlib_context_set_image(image);
-    imlib_image_set_format(cfg->screenshot_format);
-    sprintf(name+strlen(name), ".%s", cfg->screenshot_format);
-    imlib_save_image(name);
-    imlib_free_image();
-}
-
 /* 當存在合成器時，合成器會在根窗口上放置特效，即使用XSetWindowBackground*設置
  * 了背景，也會被合成器的特效擋着，目前還沒有標準的方法來設置背景。要給根窗口
  * 設置顏色，就得借助pixmap。這種情況下，若要真正地設置背景，得用E方法。這種方
@@ -121,7 +96,7 @@ static Pixmap create_pixmap_with_color(Drawable d, unsigned long color)
         || !(image=imlib_create_image(w, h)))
         return None;
 
-    Pixmap pixmap=XCreatePixmap(xinfo.display, d, w, h, depth);
+    Pixmap pixmap=create_pixmap(d, w, h, depth, "root_bg");
     if(!pixmap)
         return None;
 
@@ -138,26 +113,52 @@ static Pixmap create_pixmap_with_color(Drawable d, unsigned long color)
 static void change_prop_for_root_bg(Pixmap pixmap)
 {
     Window win=xinfo.root_win;
-    Atom prop_root=XInternAtom(xinfo.display, "_XROOTPMAP_ID", True);
-    Atom prop_esetroot=XInternAtom(xinfo.display, "ESETROOT_PMAP_ID", True);
+    const Atom *atoms=get_root_bg_atoms();
+    Atom prop_root=atoms[0], prop_esetroot=atoms[1];
+    Pixmap rid=get_pixmap_prop(win, prop_root), eid=get_pixmap_prop(win, prop_esetroot);
 
-    if(prop_root && prop_esetroot)
-    {
-        Pixmap rid=get_pixmap_prop(win, prop_root),
-               eid=get_pixmap_prop(win, prop_esetroot);
-
-        if(rid && eid && eid!=rid)
-            XKillClient(xinfo.display, rid);
-    }
+    if(rid && eid && eid!=rid)
+        XKillClient(xinfo.display, rid);
+    else if(rid && rid!=pixmap && is_xres_registered(XRES_PIXMAP, rid))
+        free_pixmap(rid); // 舊背景是本程序設置的，無需再保留
 
-    prop_root=XInternAtom(xinfo.display, "_XROOTPMAP_ID", False);
-    prop_esetroot=XInternAtom(xinfo.display, "ESETROOT_PMAP_ID", False);
     XChangeProperty(xinfo.display, win, prop_root, XA_PIXMAP, 32,
         PropModeReplace, (unsigned char *)&pixmap, 1);
     XChangeProperty(xinfo.display, win, prop_esetroot, XA_PIXMAP, 32,
         PropModeReplace, (unsigned char *)&pixmap, 1);
 }
 
+/* 返回_XROOTPMAP_ID和ESETROOT_PMAP_ID，它們只需取得一次 */
+static const Atom *get_root_bg_atoms(void)
+{
+    static Atom atoms[2]={None};
+    static char *names[]={"_XROOTPMAP_ID", "ESETROOT_PMAP_ID"};
+
+    if(!atoms[0])
+        XInternAtoms(xinfo.display, names, ARRAY_NUM(names), False, atoms);
+    return atoms;
+}
+
+/* 返回根窗口背景特性所指的pixmap */
+Pixmap get_root_bg_pixmap(void)
+{
+    return get_pixmap_prop(xinfo.root_win, get_root_bg_atoms()[0]);
+}
+
+/* 沒有合成器時無需保留本程序爲合成器設置的根窗口背景pixmap及相應特性，窗口
+ * 背景仍保持不變，因爲X服務器會保留仍被用作背景的pixmap */
+void release_root_bg_pixmap(void)
+{
+    Window win=xinfo.root_win;
+    Pixmap pixmap=get_root_bg_pixmap();
+
+    if(!pixmap || !is_xres_registered(XRES_PIXMAP, pixmap))
+        return;
+    free_pixmap(pixmap);
+    XDeleteProperty(xinfo.display, win, get_root_bg_atoms()[0]);
+    XDeleteProperty(xinfo.display, win, get_root_bg_atoms()[1]);
+}
+
 void set_override_redirect(Window win)
 {
     XSetWindowAttributes attr={.override_redirect=True};
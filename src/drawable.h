@@ -17,8 +17,9 @@
 
 bool is_pointer_on_win(Window win);
 bool is_on_screen(int x, int y, int w, int h);
-void print_area(Drawable d, int x, int y, int w, int h);
 void update_win_bg(Window win, unsigned long color, Pixmap pixmap);
+Pixmap get_root_bg_pixmap(void);
+void release_root_bg_pixmap(void);
 void set_override_redirect(Window win);
 bool get_geometry(Drawable drw, int *x, int *y, int *w, int *h, int *bw, unsigned int *depth);
 void set_visual_for_imlib(Drawable d);
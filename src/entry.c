@@ -17,6 +17,7 @@
 #include "font.h"
 #include "icccm.h"
 #include "prop.h"
+#include "xres.h"
 #include "entry.h"
 
 #define ENTRY_EVENT_MASK (ButtonPressMask|KeyPressMask|ExposureMask)
@@ -39,6 +40,7 @@ static void entry_dtor(Entry *entry);
 static int entry_get_cursor_x(Entry *entry);
 static void entry_input_ctrl_seq(Entry *entry, XKeyEvent *ke, KeySym ks);
 static void insert_wcs(wchar_t *src, size_t size, size_t *offset, const wchar_t *ins);
+static bool entry_scroll_listview(Entry *entry, KeySym ks);
 static void entry_complete(Entry *entry, bool show);
 
 Entry *entry_new(Widget *parent, Widget_id id, int x, int y, int w, int h, const char *hint, Strings *(*complete)(Entry *))
@@ -85,7 +87,7 @@ static void entry_dtor(Entry *entry)
 {
     if(entry->xic)
         XDestroyIC(entry->xic);
-    widget_del(WIDGET(entry->listview));
+    listview_del(WIDGET(entry->listview));
 }
 
 void entry_show(Widget *widget)
@@ -101,7 +103,7 @@ void entry_show(Widget *widget)
 void entry_hide(const Widget *widget)
 {
     XUngrabKeyboard(xinfo.display, CurrentTime);
-    widget_hide(WIDGET(ENTRY(widget)->listview));
+    listview_hide(WIDGET(ENTRY(widget)->listview));
     widget_hide(widget);
 }
 
@@ -123,7 +125,8 @@ void entry_update_fg(const Widget *widget)
     else
         draw_wcs(WIDGET_WIN(entry), entry->text, &fmt);
 
-    GC gc=XCreateGC(xinfo.display, WIDGET_WIN(entry), 0, NULL);
+    GC gc=get_depth_gc(xinfo.depth);
+    XSetForeground(xinfo.display, gc, fmt.fg.pixel);
     XDrawLine(xinfo.display, WIDGET_WIN(entry), gc, x, 0, x, WIDGET_H(entry));
 }
 
@@ -164,6 +167,8 @@ bool entry_input(Entry *entry, XKeyEvent *ke)
     else if(is_equal_modifier_mask(None, ke->state))
     {
         Widget *widget=WIDGET(entry);
+        if(entry_scroll_listview(entry, ks))
+            return false;
         switch(ks)
         {
             case XK_Escape:    entry_hide(widget); entry_clear(entry); return false;
@@ -211,25 +216,47 @@ static void insert_wcs(wchar_t *src, size_t size, size_t *offset, const wchar_t
     *offset = i + (ni < size-i ? ni : size-i);
 }
 
-static void entry_complete(Entry *entry, bool show)
+/* 在補全結果中移動選中條目，不必重新查詢補全結果 */
+static bool entry_scroll_listview(Entry *entry, KeySym ks)
 {
-    Strings *strs=NULL;
-    if( !entry->text[0] || !entry->complete
-        || !(strs=entry->complete(entry)) || LIST_IS_EMPTY(strs))
+    Listview *listview=entry->listview;
+    int n=listview_get_visible_n(listview);
+
+    switch(ks)
     {
-        widget_hide(WIDGET(entry->listview));
-        return;
+        case XK_Up:
+        case XK_KP_Up:        listview_move_chosen(listview, -1); break;
+        case XK_Down:
+        case XK_KP_Down:      listview_move_chosen(listview, 1); break;
+        case XK_Page_Up:
+        case XK_KP_Page_Up:   listview_move_chosen(listview, -n); break;
+        case XK_Page_Down:
+        case XK_KP_Page_Down: listview_move_chosen(listview, n); break;
+        default:              return false;
     }
+    return true;
+}
 
+/* 清單顯示構件持有補全結果的副本，故可在此釋放補全結果；補全時則採用其中的
+ * 選中條目 */
+static void entry_complete(Entry *entry, bool show)
+{
     if(show)
+    {
+        Strings *strs = entry->text[0] && entry->complete ?
+            entry->complete(entry) : NULL;
         listview_update(entry->listview, strs);
-    else
+        if(strs)
+            vfree_strings(strs);
+        return;
+    }
+
+    const char *chosen=listview_get_chosen(entry->listview);
+    if(entry->text[0] && chosen)
     {
-        Strings *first=LIST_FIRST(Strings, strs);
-        mbstowcs(entry->text, first->str, FILENAME_MAX);
+        mbstowcs(entry->text, chosen, FILENAME_MAX);
         entry->cursor_offset=wcslen(entry->text);
     }
-    vfree_strings(strs);
 }
 
 void entry_paste(Entry *entry)
@@ -245,6 +272,7 @@ void entry_paste(Entry *entry)
     wmemmove(dest, src, wcslen(entry->text)-entry->cursor_offset);
     wcsncpy(src, text, n);
     entry->cursor_offset += n;
+    entry_complete(entry, true);
     entry_update_fg(WIDGET(entry));
 }
 
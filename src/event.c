@@ -10,6 +10,7 @@
  * ************************************************************************/
 
 #include <time.h>
+#include <poll.h>
 #include <sys/select.h>
 #include <X11/Xatom.h>
 #include "clientop.h"
@@ -28,6 +29,14 @@
 #include "wmstate.h"
 #include "taskbar.h"
 #include "gui.h"
+#include "child.h"
+#include "wallpaper.h"
+#include "screenshot.h"
+#include "evstats.h"
+#include "trace.h"
+#include "fullscreen.h"
+#include "compositor.h"
+#include "ipc.h"
 #include "event.h"
 
 static void handle_button_press(XEvent *e);
@@ -48,6 +57,7 @@ static void handle_focus_in(XEvent *e);
 static void handle_focus_out(XEvent *e);
 static void handle_key_press(XEvent *e);
 static void handle_leave_notify(XEvent *e);
+static void handle_motion_notify(XEvent *e);
 static void handle_map_request(XEvent *e);
 static void handle_unmap_notify(XEvent *e);
 static void handle_property_notify(XEvent *e);
@@ -57,13 +67,63 @@ static void handle_wm_icon_name_notify(Client *c, Atom atom);
 static void handle_wm_name_notify(Window win, Atom atom);
 static void handle_wm_transient_for_notify(Window win);
 static void handle_selection_notify(XEvent *e);
+static void wait_for_events(void);
+static int get_wait_timeout(void);
+static void dispatch_x_event(XEvent *e);
+static bool handle_compositor_owner_notify(XEvent *e);
 
 void handle_x_events(void)
 {
 	XEvent e;
     XSync(xinfo.display, False);
-    while(!should_quit() && !XNextEvent(xinfo.display, &e))
-        handle_x_event(&e);
+    while(!should_quit())
+    {
+        handle_event_stats_request();
+        handle_trace_request();
+        handle_enter_focus_timeout();
+        handle_title_update_timeout();
+        handle_layout_update_request();
+        if(XPending(xinfo.display))
+            XNextEvent(xinfo.display, &e), handle_x_event(&e);
+        else
+            paint_compositor(), flush_wm_crossing_serial(), wait_for_events();
+    }
+}
+
+/* 同時等待X事件、截圖完成、壁紙解碼完成、子進程退出和IPC命令，被信號打斷或待定的聚焦、
+ * 標題更新到期時亦返回，以便及時響應退出請求。等待前先利用空閒時間做預取工
+ * 作，但全屏模式下不做，以免與全屏程序爭奪CPU */
+static void wait_for_events(void)
+{
+    // 空閒時在工作線程中預取下一張壁紙，之後須重新檢查X事件
+    if(!is_fullscreen_mode() && prefetch_wallpaper())
+        return;
+
+    size_t n=get_child_count(), m=get_ipc_pollfd_count();
+    struct pollfd fds[n+m+3];
+
+    fds[0]=(struct pollfd){ConnectionNumber(xinfo.display), POLLIN, 0};
+    fds[1]=(struct pollfd){get_screenshot_notify_fd(), POLLIN, 0};
+    fds[2]=(struct pollfd){get_wallpaper_notify_fd(), POLLIN, 0};
+    set_child_pollfds(fds+3);
+    set_ipc_pollfds(fds+3+n);
+    // XPending只在重繪之前清空了輸出緩衝區，故須確保重繪等請求在阻塞前發出
+    XFlush(xinfo.display);
+    if(poll(fds, n+m+3, get_wait_timeout()) <= 0)
+        return;
+    if(fds[1].revents & POLLIN)
+        handle_screenshot_notify();
+    if(fds[2].revents & POLLIN)
+        handle_wallpaper_notify();
+    reap_children(fds+3, n);
+    handle_ipc_events(fds+3+n, m);
+}
+
+/* 返回最早到期的待定聚焦或待定標題更新的毫秒數，兩者皆無時返回-1 */
+static int get_wait_timeout(void)
+{
+    int f=get_enter_focus_timeout(), t=get_title_update_timeout();
+    return f<0 ? t : (t<0 ? f : MIN(f, t));
 }
 
 void handle_x_event(XEvent *e)
@@ -71,6 +131,27 @@ void handle_x_event(XEvent *e)
     if(XFilterEvent(e, None))
         return;
 
+    if(trace_enabled)
+        set_trace_serial(e->xany.serial);
+    TRACE_BEGIN(get_event_name(e->type), e->xany.window);
+    if(!event_stats_enabled)
+        dispatch_x_event(e);
+    else
+    {
+        Event_stats_mark mark;
+        begin_event_stats(e, &mark);
+        dispatch_x_event(e);
+        end_event_stats(e, &mark);
+    }
+    handle_layout_update_request();
+    TRACE_END(get_event_name(e->type), e->xany.window);
+}
+
+static void dispatch_x_event(XEvent *e)
+{
+    handle_compositor_event(e);
+    if(handle_compositor_owner_notify(e))
+        return;
     switch(e->type)
     {
         case ButtonPress:       handle_button_press(e); break;
@@ -83,6 +164,7 @@ void handle_x_event(XEvent *e)
         case FocusOut:          handle_focus_out(e); break;
         case KeyPress:          handle_key_press(e); break;
         case LeaveNotify:       handle_leave_notify(e); break;
+        case MotionNotify:      handle_motion_notify(e); break;
         case MapRequest:        handle_map_request(e); break;
         case UnmapNotify:       handle_unmap_notify(e); break;
         case PropertyNotify:    handle_property_notify(e); break;
@@ -91,6 +173,18 @@ void handle_x_event(XEvent *e)
     }
 }
 
+/* 合成器啓停時切換根窗口背景的設置方式 */
+static bool handle_compositor_owner_notify(XEvent *e)
+{
+    Window owner;
+
+    if(!is_compositor_owner_notify(e, &owner))
+        return false;
+    if(update_compositor_owner(owner))
+        update_wallpaper_mode();
+    return true;
+}
+
 static void handle_button_press(XEvent *e)
 {
     Widget *clicked_widget=widget_find(e->xbutton.window),
@@ -115,7 +209,10 @@ static void exec_buttonbind_func(XEvent *e)
     Window win=e->xbutton.window;
     Widget *widget=widget_find(win);
     Widget_id id = widget ? widget->id : (win==xinfo.root_win ? ROOT_WIN : UNUSED_WIDGET_ID);
-    Client *c=win_to_client(id==CLIENT_ICON ? taskbar_get_client_win(win) : win);
+    Window cwin = id==ICONBAR ? taskbar_get_client_win(&e->xbutton) : win;
+    if(id==ICONBAR && cwin)
+        id=CLIENT_ICON;
+    Client *c=win_to_client(cwin);
     Client *tmc = c ? get_top_transient_client(c->subgroup_leader, true) : NULL;
 
     if(widget && widget->id!=TITLEBAR && widget->id!=CLIENT_FRAME)
@@ -126,7 +223,7 @@ static void exec_buttonbind_func(XEvent *e)
     
     for(const Buttonbind *p=get_buttonbinds(); p->func; p++)
     {
-        if(is_valid_click(widget, p, &e->xbutton))
+        if(is_valid_click(widget, id, p, &e->xbutton))
         {
             if(id == CLIENT_WIN)
                 XAllowEvents(xinfo.display, ReplayPointer, CurrentTime);
@@ -246,6 +343,9 @@ static void handle_enter_notify(XEvent *e)
     Pointer_act act=NO_OP;
     Widget *widget=widget_find(win);
 
+    if(cfg->focus_mode==ENTER_FOCUS && !is_wm_crossing_event(&e->xcrossing))
+        request_enter_focus(c);
+
     if(widget == NULL)
     {
         if( is_layout_adjust_area(win, x)
@@ -256,9 +356,6 @@ static void handle_enter_notify(XEvent *e)
         return;
     }
 
-    if(cfg->focus_mode==ENTER_FOCUS && c)
-        focus_client(c);
-
     if(widget->id == CLIENT_FRAME)
         act=get_resize_act(c, x, y);
     else if(widget->id == TITLEBAR)
@@ -267,13 +364,15 @@ static void handle_enter_notify(XEvent *e)
     {
         if(widget->id == CLOSE_BUTTON)
             widget->state.warn=1;
+        else if(widget->id == ICONBAR)
+            taskbar_point_iconbar(e->xcrossing.x);
         widget->state.hot=1;
         widget_update_bg(widget);
     }
 
     if(widget->id != UNUSED_WIDGET_ID)
         set_cursor(win, act);
-    if(widget && widget->tooltip)
+    if(widget && widget->tooltip && !is_fullscreen_mode())
         handle_pointer_hover(widget);
 }
 
@@ -396,6 +495,13 @@ static void handle_leave_notify(XEvent *e)
         set_cursor(win, NO_OP);
 }
 
+static void handle_motion_notify(XEvent *e)
+{
+    Widget *widget=widget_find(e->xmotion.window);
+    if(widget && widget->id==ICONBAR)
+        taskbar_point_iconbar(e->xmotion.x);
+}
+
 static void handle_map_request(XEvent *e)
 {
     Window win=e->xmaprequest.window;
@@ -437,8 +543,16 @@ static void handle_property_notify(XEvent *e)
     Client *c=win_to_client(win);
     Atom atom=e->xproperty.atom;
 
+    /* 框架創建時已複製全部屬性，此後只需同步發生變化的屬性 */
     if(c && cfg->set_frame_prop)
-        copy_prop(WIDGET_WIN(c->frame), WIDGET_WIN(c));
+    {
+        if(e->xproperty.state == PropertyDelete)
+            XDeleteProperty(xinfo.display, WIDGET_WIN(c->frame), atom);
+        else if(is_fullscreen_mode())
+            defer_frame_prop(WIDGET_WIN(c), atom);
+        else
+            copy_spec_prop(WIDGET_WIN(c->frame), WIDGET_WIN(c), atom);
+    }
     if(c && atom==XA_WM_HINTS)
         handle_wm_hints_notify(c);
     else if(c && atom==XA_WM_NORMAL_HINTS)
@@ -468,7 +582,7 @@ static void handle_property_notify(XEvent *e)
         || is_spec_gwm_atom(atom, GWM_LAYOUT))
         taskbar_update_bg();
     else if(is_spec_gwm_atom(atom, GWM_UPDATE_LAYOUT))
-        update_layout();
+        request_layout_update();
     else if(is_spec_gwm_atom(atom, GWM_MAIN_COLOR_NAME))
         update_gui();
 }
@@ -508,21 +622,16 @@ static void handle_wm_icon_name_notify(Client *c, Atom atom)
 
 static void handle_wm_name_notify(Window win, Atom atom)
 {
-    char *s=get_text_prop(win, atom);
     Client *c=win_to_client(win);
 
-    if((win!=xinfo.root_win && !c) || !s)
-        return;
-
-    if(win == xinfo.root_win)
-        taskbar_change_statusbar_label(s);
-    else
+    if(c)
+        request_title_update(c);
+    else if(win == xinfo.root_win)
     {
-        Free(c->title_text);
-        c->title_text=copy_string(s);
-        frame_change_title(c->frame, s);
+        char *s=get_text_prop(win, atom);
+        if(s)
+            taskbar_change_statusbar_label(s), Free(s);
     }
-    Free(s);
 }
 
 static void handle_wm_transient_for_notify(Window win)
@@ -0,0 +1,236 @@
+/* *************************************************************************
+ *     evstats.c：實現事件處理延遲及X請求數的統計功能。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include <signal.h>
+#include <string.h>
+#include <stdint.h>
+#include <X11/Xlibint.h>
+#include "config.h"
+#include "misc.h"
+#include "xres.h"
+#include "evstats.h"
+
+/* 按事件類型分別統計處理耗時的直方圖、發出的X請求數及輸出緩衝區的刷新次數。
+ * Xlib的同步調用（如XGetWindowProperty）必須先刷新輸出緩衝區再等待答復，因
+ * 此刷新次數近似於往返次數的上限。統計結果在收到SIGUSR1時輸出至標準錯誤 */
+#define EVENT_STATS_BUCKET_N 16 // 直方圖的桶數，第i個桶統計耗時小於2^i微秒且不小於2^(i-1)微秒的事件，最後一個桶不設上限
+
+typedef struct // 某類事件的統計數據
+{
+    unsigned long count, requests, flushes; // 事件數、X請求數、刷新次數
+    unsigned long total_us, max_us; // 總耗時、最大耗時
+    unsigned long hist[EVENT_STATS_BUCKET_N]; // 耗時直方圖
+    Window slowest_win; // 耗時最大的事件的窗口
+    unsigned long slowest_serial; // 耗時最大的事件的序號
+} Event_stats;
+
+typedef struct // 事件隊列及服務器時間戳延遲的統計數據
+{
+    unsigned long queue_max, queue_total; // 隊列中尚待處理事件數的最大值、總和
+    unsigned long lag_count, lag_max, lag_total; // 帶時間戳的事件數、延遲的最大值、總和
+    bool has_lag_base; // lag_base是否有效
+    int64_t lag_base; // 已觀測到的本地時刻與服務器時間戳的最小差值
+} Queue_stats;
+
+bool event_stats_enabled=false;
+static Event_stats event_stats[LASTEvent]; // 0號元素用於統計擴展事件
+static Queue_stats queue_stats;
+static unsigned long flushes=0; // 輸出緩衝區的刷新次數
+static volatile sig_atomic_t dump_requested=0;
+
+static void count_flush(Display *display, XExtCodes *codes, const char *data, long len);
+static void request_dump(int signum);
+static int get_bucket_index(unsigned long us);
+static void update_queue_stats(const XEvent *e, uint64_t now);
+static bool get_event_time(const XEvent *e, Time *t);
+
+void init_event_stats(void)
+{
+    if(!cfg->event_stats)
+        return;
+
+    XExtCodes *codes=XAddExtension(xinfo.display);
+    if(!codes)
+        return;
+    XESetBeforeFlush(xinfo.display, codes->extension, count_flush);
+    if(signal(SIGUSR1, request_dump) == SIG_ERR)
+        perror(_("不能安裝SIGUSR1信號處理函數"));
+    event_stats_enabled=true;
+}
+
+/* Xlib把請求寫入緩衝區時，若緩衝區已空，會以兩段數據分別調用本函數，此時只
+ * 計一次 */
+static void count_flush(Display *display, XExtCodes *codes, const char *data, long len)
+{
+    UNUSED(codes);
+    if(data==display->buffer ? len>0 : display->bufptr==display->buffer)
+        flushes++;
+}
+
+static void request_dump(int signum)
+{
+    UNUSED(signum);
+    dump_requested=1;
+}
+
+void begin_event_stats(const XEvent *e, Event_stats_mark *mark)
+{
+    mark->start=get_monotonic_us();
+    mark->request=NextRequest(xinfo.display);
+    mark->flushes=flushes;
+    update_queue_stats(e, mark->start);
+}
+
+void end_event_stats(const XEvent *e, const Event_stats_mark *mark)
+{
+    unsigned long us=get_monotonic_us()-mark->start;
+    Event_stats *s=event_stats+(e->type<LASTEvent ? e->type : 0);
+
+    s->count++;
+    s->requests += NextRequest(xinfo.display)-mark->request;
+    s->flushes += flushes-mark->flushes;
+    s->total_us += us;
+    s->hist[get_bucket_index(us)]++;
+    if(us >= s->max_us)
+    {
+        s->max_us=us;
+        s->slowest_win=e->xany.window;
+        s->slowest_serial=e->xany.serial;
+    }
+}
+
+static int get_bucket_index(unsigned long us)
+{
+    int i=0;
+    for(; us && i<EVENT_STATS_BUCKET_N-1; us>>=1)
+        i++;
+    return i;
+}
+
+/* 服務器時間戳與本地時鐘的原點不同，故以已觀測到的兩者最小差值爲基準，事件
+ * 的延遲即其差值超出基準的部分 */
+static void update_queue_stats(const XEvent *e, uint64_t now)
+{
+    Queue_stats *q=&queue_stats;
+    unsigned long n=XEventsQueued(xinfo.display, QueuedAlready);
+    Time t;
+
+    q->queue_total += n;
+    q->queue_max=MAX(q->queue_max, n);
+    if(!get_event_time(e, &t))
+        return;
+
+    int64_t diff=(int64_t)(now/1000)-(int64_t)t;
+    if(!q->has_lag_base || diff<q->lag_base)
+        q->lag_base=diff, q->has_lag_base=true;
+
+    unsigned long lag=diff-q->lag_base;
+    q->lag_count++;
+    q->lag_total += lag;
+    q->lag_max=MAX(q->lag_max, lag);
+}
+
+static bool get_event_time(const XEvent *e, Time *t)
+{
+    switch(e->type)
+    {
+        case KeyPress:
+        case KeyRelease:       *t=e->xkey.time; break;
+        case ButtonPress:
+        case ButtonRelease:    *t=e->xbutton.time; break;
+        case MotionNotify:     *t=e->xmotion.time; break;
+        case EnterNotify:
+        case LeaveNotify:      *t=e->xcrossing.time; break;
+        case PropertyNotify:   *t=e->xproperty.time; break;
+        case SelectionClear:   *t=e->xselectionclear.time; break;
+        case SelectionRequest: *t=e->xselectionrequest.time; break;
+        case SelectionNotify:  *t=e->xselection.time; break;
+        default: return false;
+    }
+    return *t != CurrentTime;
+}
+
+void handle_event_stats_request(void)
+{
+    if(!dump_requested)
+        return;
+    dump_requested=0;
+    dump_event_stats(stderr);
+    dump_xres(stderr);
+    reset_event_stats();
+}
+
+void dump_event_stats(FILE *fp)
+{
+    const Queue_stats *q=&queue_stats;
+    unsigned long n=0;
+
+    fprintf(fp, _("以下是事件處理統計（耗時單位爲微秒）：\n"));
+    fprintf(fp, "%-18s %8s %8s %8s %8s %8s %10s %8s\n", "type", "count",
+        "avg", "max", "requests", "flushes", "slowest", "serial");
+    for(int i=0; i<LASTEvent; i++)
+    {
+        const Event_stats *s=event_stats+i;
+        if(!s->count)
+            continue;
+        n += s->count;
+        fprintf(fp, "%-18s %8lu %8lu %8lu %8lu %8lu %10lx %8lu\n",
+            get_event_name(i), s->count, s->total_us/s->count, s->max_us,
+            s->requests, s->flushes, s->slowest_win, s->slowest_serial);
+        fprintf(fp, "%-18s", "  histogram");
+        for(int j=0; j<EVENT_STATS_BUCKET_N; j++)
+            fprintf(fp, " %lu", s->hist[j]);
+        fputc('\n', fp);
+    }
+    if(n)
+        fprintf(fp, _("隊列深度：最大%lu，平均%.2f\n"), q->queue_max,
+            (double)q->queue_total/n);
+    if(q->lag_count)
+        fprintf(fp, _("服務器時間戳延遲（毫秒）：最大%lu，平均%.2f\n"),
+            q->lag_max, (double)q->lag_total/q->lag_count);
+    fflush(fp);
+}
+
+void reset_event_stats(void)
+{
+    memset(event_stats, 0, sizeof(event_stats));
+    memset(&queue_stats, 0, sizeof(queue_stats));
+}
+
+const char *get_event_name(int type)
+{
+    static const char *names[LASTEvent]=
+    {
+        [0]="Extension", [KeyPress]="KeyPress", [KeyRelease]="KeyRelease",
+        [ButtonPress]="ButtonPress", [ButtonRelease]="ButtonRelease",
+        [MotionNotify]="MotionNotify", [EnterNotify]="EnterNotify",
+        [LeaveNotify]="LeaveNotify", [FocusIn]="FocusIn",
+        [FocusOut]="FocusOut", [KeymapNotify]="KeymapNotify",
+        [Expose]="Expose", [GraphicsExpose]="GraphicsExpose",
+        [NoExpose]="NoExpose", [VisibilityNotify]="VisibilityNotify",
+        [CreateNotify]="CreateNotify", [DestroyNotify]="DestroyNotify",
+        [UnmapNotify]="UnmapNotify", [MapNotify]="MapNotify",
+        [MapRequest]="MapRequest", [ReparentNotify]="ReparentNotify",
+        [ConfigureNotify]="ConfigureNotify",
+        [ConfigureRequest]="ConfigureRequest",
+        [GravityNotify]="GravityNotify", [ResizeRequest]="ResizeRequest",
+        [CirculateNotify]="CirculateNotify",
+        [CirculateRequest]="CirculateRequest",
+        [PropertyNotify]="PropertyNotify", [SelectionClear]="SelectionClear",
+        [SelectionRequest]="SelectionRequest",
+        [SelectionNotify]="SelectionNotify", [ColormapNotify]="ColormapNotify",
+        [ClientMessage]="ClientMessage", [MappingNotify]="MappingNotify",
+        [GenericEvent]="GenericEvent",
+    };
+    if(type<0 || type>=LASTEvent)
+        type=0;
+    return names[type] ? names[type] : "Unknown";
+}
@@ -0,0 +1,37 @@
+/* *************************************************************************
+ *     evstats.h：與evstats.c相應的頭文件。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#ifndef EVSTATS_H
+#define EVSTATS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <X11/Xlib.h>
+
+typedef struct // 開始處理某個事件時的計數快照
+{
+    uint64_t start; // 開始時刻（單調時鐘的微秒數）
+    unsigned long request; // 下一個X請求的序號
+    unsigned long flushes; // 已刷新輸出緩衝區的次數
+} Event_stats_mark;
+
+extern bool event_stats_enabled; // 是否正在統計，供熱路徑以最小代價判斷
+
+void init_event_stats(void);
+void begin_event_stats(const XEvent *e, Event_stats_mark *mark);
+void end_event_stats(const XEvent *e, const Event_stats_mark *mark);
+void handle_event_stats_request(void);
+void dump_event_stats(FILE *fp);
+void reset_event_stats(void);
+const char *get_event_name(int type);
+
+#endif
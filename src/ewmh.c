@@ -10,6 +10,13 @@
  * ************************************************************************/
 
 #include <stdio.h>
+#include <limits.h>
+#include <stdint.h>
+#include <X11/Xatom.h>
+#include <X11/extensions/Xfixes.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "gwm.h"
 #include "prop.h"
 #include "icccm.h"
@@ -50,14 +57,23 @@ static const char *ewmh_atom_names[EWMH_ATOM_N]= // EWMH規範標識符名稱
     "_NET_WM_ICON", "_NET_WM_PID", "_NET_WM_HANDLED_ICONS",
     "_NET_WM_USER_TIME", "_NET_WM_USER_TIME_WINDOW", "_NET_FRAME_EXTENTS",
     "_NET_WM_OPAQUE_REGION", "_NET_WM_BYPASS_COMPOSITOR", "_NET_WM_PING",
-    "_NET_WM_SYNC_REQUEST", "_NET_WM_FULLSCREEN_MONITORS",
+    "_NET_WM_SYNC_REQUEST", "_NET_WM_SYNC_REQUEST_COUNTER", "_NET_WM_FULLSCREEN_MONITORS",
     "_NET_WM_FULL_PLACEMENT",
     "GWM_WM_STATE_MAXIMIZED_TOP", "GWM_WM_STATE_MAXIMIZED_BOTTOM",
     "GWM_WM_STATE_MAXIMIZED_LEFT", "GWM_WM_STATE_MAXIMIZED_RIGHT",
 };
 
+#define NET_WM_ICON_SIZE_MAX 4096 // 圖標邊長的上限，以防惡意的寬高導致溢出
+
 static Atom ewmh_atoms[EWMH_ATOM_N]; // EWMH規範標識符，與上表相應
+static Atom net_wm_cm_atom=None; // _NET_WM_CM_Sn
+static Window compositor=None; // _NET_WM_CM_Sn選擇區的所有者
+static int xfixes_event=-1; // XFixes擴展的事件基值，-1表示不能跟蹤所有者的變化
 static void set_net_client_list_by_order(const Window *wins, int n, bool stack);
+static bool get_net_wm_icon_header(Window win, long offset, long *w, long *h, unsigned long *rest);
+static bool is_better_net_wm_icon(long w, long h, long bw, long bh, int size);
+static uint32_t *get_net_wm_icon_pixels(Window win, long offset, long iw, long ih, int *w, int *h);
+static void pack_cardinals(uint32_t *dst, const long *src, size_t n);
 
 bool is_spec_ewmh_atom(Atom spec, EWMH_atom_id id)
 {
@@ -369,6 +385,46 @@ bool is_win_state_max(Net_wm_state state)
         || state.bmax || state.lmax || state.rmax;
 }
 
+/* 經由XFixes擴展監視_NET_WM_CM_Sn選擇區所有者的變化，以免每次判斷是否存在
+ * 合成器時都要向X服務器查詢。X服務器不支持XFixes擴展時纔退而每次查詢 */
+void init_compositor_owner(void)
+{
+    Display *d=xinfo.display;
+    int event, error, major=2, minor=0;
+
+    if( XFixesQueryExtension(d, &event, &error)
+        && XFixesQueryVersion(d, &major, &minor) && major>=1)
+    {
+        XFixesSelectSelectionInput(d, xinfo.root_win, get_net_wm_cm_atom(),
+            XFixesSetSelectionOwnerNotifyMask
+            | XFixesSelectionWindowDestroyNotifyMask
+            | XFixesSelectionClientCloseNotifyMask);
+        xfixes_event=event;
+    }
+    compositor=XGetSelectionOwner(d, get_net_wm_cm_atom());
+}
+
+/* 若e是_NET_WM_CM_Sn選擇區所有者變化的通知，則由owner返回新所有者 */
+bool is_compositor_owner_notify(const XEvent *e, Window *owner)
+{
+    const XFixesSelectionNotifyEvent *se=(const XFixesSelectionNotifyEvent *)e;
+
+    if( xfixes_event<0 || e->type!=xfixes_event+XFixesSelectionNotify
+        || se->selection!=get_net_wm_cm_atom())
+        return false;
+    *owner = se->subtype==XFixesSetSelectionOwnerNotify ? se->owner : None;
+    return true;
+}
+
+/* 記錄合成器的ID，返回其是否有變化 */
+bool update_compositor_owner(Window owner)
+{
+    if(xfixes_event<0 || owner==compositor)
+        return false;
+    compositor=owner;
+    return true;
+}
+
 /* 判斷是否存在（遵從EWMH標準的）合成器 */
 bool have_compositor(void)
 {
@@ -378,12 +434,21 @@ bool have_compositor(void)
 /* 獲取（遵從EWMH標準的）合成器的ID，它未必是真實的窗口 */
 Window get_compositor(void)
 {
-    char prop_name[32];
+    if(xfixes_event < 0)
+        return XGetSelectionOwner(xinfo.display, get_net_wm_cm_atom());
+    return compositor;
+}
 
-    // 遵守EWMH標準的合成器都會獲取名爲_NET_WM_CM_Sn的選擇區所有權
-    snprintf(prop_name, 32, "_NET_WM_CM_S%d", xinfo.screen);
-    Atom prop_atom=XInternAtom(xinfo.display, prop_name, False);
-    return XGetSelectionOwner(xinfo.display, prop_atom);
+/* 遵守EWMH標準的合成器都會獲取名爲_NET_WM_CM_Sn的選擇區所有權 */
+Atom get_net_wm_cm_atom(void)
+{
+    if(!net_wm_cm_atom)
+    {
+        char prop_name[32];
+        snprintf(prop_name, 32, "_NET_WM_CM_S%d", xinfo.screen);
+        net_wm_cm_atom=XInternAtom(xinfo.display, prop_name, False);
+    }
+    return net_wm_cm_atom;
 }
 
 char *get_net_wm_name(Window win)
@@ -396,7 +461,129 @@ char *get_net_wm_icon_name(Window win)
     return get_text_prop(win, ewmh_atoms[NET_WM_ICON_NAME]);
 }
 
-long *get_net_wm_icon(Window win)
+/* _NET_WM_ICON可能含有多個尺寸的圖標，大圖標的像素數據可達數MB，因此先分段
+ * 讀取各圖標的寬高，選出邊長不小於size的最小圖標（若無則取最大者），再只讀取
+ * 該圖標的像素。返回按ARGB格式打包的CARD32數組，其寬、高由w、h返回 */
+uint32_t *get_net_wm_icon(Window win, int size, int *w, int *h)
+{
+    long offset=0, best=-1, iw=0, ih=0, bw=0, bh=0;
+    unsigned long rest=0;
+
+    while(get_net_wm_icon_header(win, offset, &iw, &ih, &rest))
+    {
+        if(is_better_net_wm_icon(iw, ih, bw, bh, size))
+            best=offset, bw=iw, bh=ih;
+        if(rest < (unsigned long)(iw*ih+2)*4) // 已是最後一個圖標
+            break;
+        offset += 2+iw*ih;
+    }
+
+    return best<0 ? NULL : get_net_wm_icon_pixels(win, best, bw, bh, w, h);
+}
+
+/* 讀取偏移爲offset（以32位爲單位）處的圖標寬高，rest返回其後剩餘的字節數 */
+static bool get_net_wm_icon_header(Window win, long offset, long *w, long *h, unsigned long *rest)
+{
+    int fmt;
+    unsigned long n=0;
+    unsigned char *p=NULL;
+    Atom type;
+    bool result=false;
+
+    if( XGetWindowProperty(xinfo.display, win, ewmh_atoms[NET_WM_ICON], offset,
+        2, False, XA_CARDINAL, &type, &fmt, &n, rest, &p) == Success
+        && type==XA_CARDINAL && fmt==32 && n==2 && p)
+    {
+        *w=((long *)p)[0], *h=((long *)p)[1];
+        result = *w>0 && *h>0 && *w<=NET_WM_ICON_SIZE_MAX
+            && *h<=NET_WM_ICON_SIZE_MAX && (unsigned long)(*w**h)*4<=*rest;
+    }
+    if(p)
+        XFree(p);
+
+    return result;
+}
+
+static bool is_better_net_wm_icon(long w, long h, long bw, long bh, int size)
+{
+    long s=MAX(w, h), bs=MAX(bw, bh);
+
+    if(bs == 0)
+        return true;
+    if(s >= size)
+        return bs<size || s<bs;
+    return bs<size && s>bs;
+}
+
+static uint32_t *get_net_wm_icon_pixels(Window win, long offset, long iw, long ih, int *w, int *h)
+{
+    int fmt;
+    unsigned long n=0, rest=0;
+    unsigned char *p=NULL;
+    Atom type;
+    uint32_t *pixels=NULL;
+
+    if( XGetWindowProperty(xinfo.display, win, ewmh_atoms[NET_WM_ICON], offset+2,
+        iw*ih, False, XA_CARDINAL, &type, &fmt, &n, &rest, &p) == Success
+        && type==XA_CARDINAL && fmt==32 && n==(unsigned long)(iw*ih) && p)
+    {
+        pixels=Malloc(n*sizeof(uint32_t));
+        pack_cardinals(pixels, (long *)p, n);
+        *w=iw, *h=ih;
+    }
+    if(p)
+        XFree(p);
+
+    return pixels;
+}
+
+/* Xlib以long數組返回32位格式的特性值，LP64下需取各元素的低32位。SSE2下每次
+ * 讀入4個long，把各自的低32位拼成4個CARD32 */
+static void pack_cardinals(uint32_t *dst, const long *src, size_t n)
 {
-    return get_cardinals_prop(win, ewmh_atoms[NET_WM_ICON], NULL);
+    size_t i=0;
+
+#if defined(__SSE2__) && LONG_MAX > INT32_MAX
+    for(; i+4 <= n; i+=4)
+    {
+        __m128i a=_mm_loadu_si128((const __m128i *)(src+i)),
+                b=_mm_loadu_si128((const __m128i *)(src+i+2));
+        a=_mm_shuffle_epi32(a, _MM_SHUFFLE(3, 1, 2, 0));
+        b=_mm_shuffle_epi32(b, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128((__m128i *)(dst+i), _mm_unpacklo_epi64(a, b));
+    }
+#endif
+    for(; i<n; i++)
+        dst[i]=src[i];
+}
+
+/* 僅當客戶在WM_PROTOCOLS中聲明支持_NET_WM_SYNC_REQUEST時，其計數器纔有效 */
+XID get_net_wm_sync_request_counter(Window win)
+{
+    if(!has_spec_wm_protocol(win, ewmh_atoms[NET_WM_SYNC_REQUEST]))
+        return None;
+    return get_cardinal_prop(win, ewmh_atoms[NET_WM_SYNC_REQUEST_COUNTER], None);
+}
+
+/* 每次調整尺寸都要發送，故不再經XGetWMProtocols檢查，以免往返通信。調用者應
+ * 已通過get_net_wm_sync_request_counter確認客戶支持本協議 */
+bool send_net_wm_sync_request(Window win, long value_lo, long value_hi)
+{
+    return send_protocol_client_msg(ewmh_atoms[NET_WM_SYNC_REQUEST], win,
+        value_lo, value_hi);
+}
+
+/* 值爲0表示無偏好，1表示請求合成器停止重定向窗口，2表示請求不要停止 */
+long get_net_wm_bypass_compositor(Window win)
+{
+    return get_cardinal_prop(win, ewmh_atoms[NET_WM_BYPASS_COMPOSITOR], 0);
+}
+
+void set_net_wm_bypass_compositor(Window win, long value)
+{
+    Atom prop=ewmh_atoms[NET_WM_BYPASS_COMPOSITOR];
+    if(value)
+        replace_cardinal_prop(win, prop, value);
+    else
+        XDeleteProperty(xinfo.display, win, prop);
 }
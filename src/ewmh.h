@@ -13,6 +13,7 @@
 #define HINT_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <X11/Xlib.h>
 #include <X11/Xproto.h>
 #include "gwm.h"
@@ -51,7 +52,7 @@ typedef enum // 與EWMH規範標識符名稱表(ewmh_atom_names)相應的ID
     NET_WM_ICON, NET_WM_PID, NET_WM_HANDLED_ICONS,
     NET_WM_USER_TIME, NET_WM_USER_TIME_WINDOW, NET_FRAME_EXTENTS,
     NET_WM_OPAQUE_REGION, NET_WM_BYPASS_COMPOSITOR, NET_WM_PING,
-    NET_WM_SYNC_REQUEST, NET_WM_FULLSCREEN_MONITORS,
+    NET_WM_SYNC_REQUEST, NET_WM_SYNC_REQUEST_COUNTER, NET_WM_FULLSCREEN_MONITORS,
     NET_WM_FULL_PLACEMENT,
     GWM_WM_STATE_MAXIMIZED_TOP, GWM_WM_STATE_MAXIMIZED_BOTTOM,
     GWM_WM_STATE_MAXIMIZED_LEFT, GWM_WM_STATE_MAXIMIZED_RIGHT,
@@ -125,10 +126,18 @@ Net_wm_state get_net_wm_state(Window win);
 void update_net_wm_state(Window win, Net_wm_state state);
 Net_wm_state get_net_wm_state_mask(const long *full_act);
 bool is_win_state_max(Net_wm_state state);
+void init_compositor_owner(void);
+bool is_compositor_owner_notify(const XEvent *e, Window *owner);
+bool update_compositor_owner(Window owner);
 bool have_compositor(void);
 Window get_compositor(void);
+Atom get_net_wm_cm_atom(void);
 char *get_net_wm_name(Window win);
 char *get_net_wm_icon_name(Window win);
-long *get_net_wm_icon(Window win);
+uint32_t *get_net_wm_icon(Window win, int size, int *w, int *h);
+XID get_net_wm_sync_request_counter(Window win);
+bool send_net_wm_sync_request(Window win, long value_lo, long value_hi);
+long get_net_wm_bypass_compositor(Window win);
+void set_net_wm_bypass_compositor(Window win, long value);
 
 #endif
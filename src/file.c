@@ -9,142 +9,320 @@
  * <http://www.gnu.org/licenses/>。
  * ************************************************************************/
 
+#define _GNU_SOURCE // 爲了使用openat、fdopendir、fstatat、struct dirent的d_type成員及POSIX_SPAWN_SETSID
+
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <dirent.h>
 #include "misc.h"
 #include "gwm.h"
 #include "config.h"
 #include "list.h"
+#include "child.h"
 #include "file.h"
 
-static void add_files_in_path(Strings *head, const char *path, const char *regex, bool fullname);
-static bool is_dir(const char *filename);
-static bool regcmp(const char *s, const char *regex);
-static bool match(const char *s, const char *r);
-static void add_file(Strings *head, const char *path, const char *filename, bool fullname);
-static Strings *create_file_node(const char *path, const char *filename, bool fullname);
-static Strings *get_file_insert_point(Strings *head, Strings *file, bool order);
-static int cmp_basename(const char *s1, const char *s2);
+typedef enum // 模式選擇分支的種類，用於選擇匹配方式
+{
+    ALT_EXACT, ALT_PREFIX, ALT_SUFFIX, ALT_GLOB,
+} Alt_kind;
+
+typedef struct // 模式中以'|'分隔的選擇分支
+{
+    Alt_kind kind;
+    char *str; // 規範後的分支，對於ALT_PREFIX和ALT_SUFFIX則是去掉*後的分支
+    size_t len; // str的有效長度
+} Alt;
+
+typedef struct // 編譯後的簡單正則表達式
+{
+    Alt *alts;
+    size_t n;
+} Pattern;
+
+typedef struct // 遍歷目錄時收集的文件名
+{
+    char **names;
+    size_t n, size; // 文件名數量及names的容量
+} Files;
+
+typedef struct dir_node_tag // 正在遍歷的目錄，用於檢測符號鏈接造成的循環
+{
+    dev_t dev;
+    ino_t ino;
+    const struct dir_node_tag *parent;
+} Dir_node;
+
+static Pattern *compile_pattern(const char *regex);
+static void compile_alt(Alt *alt, const char *begin, const char *end);
+static void free_pattern(Pattern *pattern);
+static void add_files_in_dir(Files *files, int fd, const char *path, const Pattern *pattern, bool fullname, int depth, const Dir_node *parent);
+static bool is_dir_entry(int dir_fd, const struct dirent *d);
+static bool is_visited_dir(const Dir_node *node, dev_t dev, ino_t ino);
+static bool match_pattern(const Pattern *pattern, const char *s);
+static bool match_alt(const Alt *alt, const char *s);
+static bool match_chars(const char *s, const char *r, size_t n);
+static bool match_glob(const char *s, const char *r);
+static void add_file(Files *files, const char *path, const char *filename, bool fullname);
+static Strings *files_to_strings(Files *files);
+static int cmp_basename(const void *p1, const void *p2);
 
-Strings *get_files_in_paths(const char *paths, const char *regex, bool fullname)
+/* 功能：獲取paths中各目錄及其子目錄下文件名匹配regex的文件，結果按文件名升序排列。
+ * 說明：fullname爲真時結果包含路徑；max_depth限制遞歸進入子目錄的層數，爲負時
+ * 不限層數。經符號鏈接回到正在遍歷的目錄時不再進入。
+ */
+Strings *get_files_in_paths(const char *paths, const char *regex, bool fullname, int max_depth)
 {
     char *p=NULL, *ps=copy_string(paths);
-    Strings *files=Malloc(sizeof(Strings));
+    Files files={NULL, 0, 0};
+    Pattern *pattern=compile_pattern(regex);
 
-    LIST_INIT(files);
     for(p=strtok(ps, ":"); p; p=strtok(NULL, ":"))
-        add_files_in_path(files, p, regex, fullname);
+    {
+        int fd=open(p, O_RDONLY|O_DIRECTORY|O_CLOEXEC);
+        if(fd >= 0)
+            add_files_in_dir(&files, fd, p, pattern, fullname, max_depth, NULL);
+    }
+    free_pattern(pattern);
     Free(ps);
 
-    return files;
+    return files_to_strings(&files);
+}
+
+/* 功能：編譯簡單的正則表達式，僅支持：.、*、|。
+ * 說明：.匹配一個字符，*和.*匹配>=0個任意字符，|分隔選擇分支，每個分支都須
+ * 匹配整個字符串。
+ */
+static Pattern *compile_pattern(const char *regex)
+{
+    Pattern *pattern=Malloc(sizeof(Pattern));
+    const char *p=regex, *end=NULL;
+
+    pattern->n=1;
+    for(; (p=strchr(p, '|')); p++)
+        pattern->n++;
+    pattern->alts=Malloc(pattern->n*sizeof(Alt));
+    p=regex;
+    for(size_t i=0; i<pattern->n; i++, p=end+1)
+    {
+        end=strchr(p, '|');
+        end=(end ? end : p+strlen(p));
+        compile_alt(pattern->alts+i, p, end);
+    }
+
+    return pattern;
+}
+
+/* 把.*規範爲*並合併連續的*，再按*的位置確定分支的種類。只在首或尾有*的分支
+ * 只需比較一次後綴或前綴 */
+static void compile_alt(Alt *alt, const char *begin, const char *end)
+{
+    char *s=Malloc(end-begin+1), *d=s;
+
+    for(const char *p=begin; p<end; p++)
+    {
+        bool star = *p=='*' || (*p=='.' && p+1<end && p[1]=='*');
+        if(!star)
+            *d++=*p;
+        else if(!(d>s && d[-1]=='*'))
+            *d++='*';
+        if(star && *p=='.')
+            p++;
+    }
+    *d='\0';
+
+    size_t len=d-s;
+    char *first=strchr(s, '*'), *last=strrchr(s, '*');
+    alt->str=s, alt->len=len;
+    if(!first)
+        alt->kind=ALT_EXACT;
+    else if(first==s && last==s)
+        alt->kind=ALT_SUFFIX, alt->len=len-1, memmove(s, s+1, len);
+    else if(first == s+len-1)
+        alt->kind=ALT_PREFIX, alt->len=len-1;
+    else
+        alt->kind=ALT_GLOB;
+}
+
+static void free_pattern(Pattern *pattern)
+{
+    for(size_t i=0; i<pattern->n; i++)
+        free(pattern->alts[i].str);
+    vfree(pattern->alts, pattern);
 }
 
-static void add_files_in_path(Strings *head, const char *path, const char *regex, bool fullname)
+/* 在fd所指目錄內按d_type判斷文件類型，只對類型未知或爲符號鏈接的目錄項調用
+ * fstatat，並只爲子目錄拼接路徑。本函數負責關閉fd */
+static void add_files_in_dir(Files *files, int fd, const char *path, const Pattern *pattern, bool fullname, int depth, const Dir_node *parent)
 {
-    DIR *dir=opendir(path);
+    struct stat st;
+    DIR *dir=NULL;
 
-    if(dir == NULL)
+    if(fstat(fd, &st) || is_visited_dir(parent, st.st_dev, st.st_ino) || !(dir=fdopendir(fd)))
+    {
+        close(fd);
         return;
+    }
 
+    Dir_node node={st.st_dev, st.st_ino, parent};
     for(struct dirent *d=NULL; (d=readdir(dir));)
     {
-        if(strcmp(".", d->d_name) && strcmp("..", d->d_name))
+        if(!strcmp(".", d->d_name) || !strcmp("..", d->d_name))
+            continue;
+        if(is_dir_entry(dirfd(dir), d))
         {
-            char *fn=copy_strings(path, "/", d->d_name, NULL);
-            if(is_dir(fn))
-                add_files_in_path(head, fn, regex, fullname);
-            else if(regcmp(d->d_name, regex))
-                add_file(head, path, d->d_name, fullname);
-            Free(fn);
+            int subfd=-1;
+            if( depth && (subfd=openat(dirfd(dir), d->d_name,
+                O_RDONLY|O_DIRECTORY|O_CLOEXEC)) >= 0)
+            {
+                char *subpath=copy_strings(path, "/", d->d_name, NULL);
+                add_files_in_dir(files, subfd, subpath, pattern, fullname, depth-1, &node);
+                Free(subpath);
+            }
         }
+        else if(match_pattern(pattern, d->d_name))
+            add_file(files, path, d->d_name, fullname);
     }
     closedir(dir);
 }
 
-static bool is_dir(const char *filename)
+static bool is_dir_entry(int dir_fd, const struct dirent *d)
 {
-    struct stat buf;
-    return stat(filename, &buf)==0 && S_ISDIR(buf.st_mode);
+    struct stat st;
+
+    if(d->d_type!=DT_UNKNOWN && d->d_type!=DT_LNK)
+        return d->d_type == DT_DIR;
+    return fstatat(dir_fd, d->d_name, &st, 0)==0 && S_ISDIR(st.st_mode);
 }
 
-/* 簡單的正則表達式匹配，僅支持：.、*、| */
-static bool regcmp(const char *s, const char *regex)
+static bool is_visited_dir(const Dir_node *node, dev_t dev, ino_t ino)
 {
-    do
-    {
-        if(match(s, regex))
+    for(; node; node=node->parent)
+        if(node->dev==dev && node->ino==ino)
             return true;
-    } while((regex=strchr(regex, '|')) && ++regex);
+    return false;
+}
 
+static bool match_pattern(const Pattern *pattern, const char *s)
+{
+    for(size_t i=0; i<pattern->n; i++)
+        if(match_alt(pattern->alts+i, s))
+            return true;
     return false;
 }
 
-/* 功能：匹配正則表達式r。
- * 說明：*匹配>=0個前一字符，.匹配一個字符，|匹配其兩側的表達式。
- */
-static bool match(const char *s, const char *r)
+static bool match_alt(const Alt *alt, const char *s)
 {
-    switch(*r)
+    size_t len=strlen(s);
+
+    switch(alt->kind)
     {
-        case '\0': return !*s;
-        case '*':  return match(s, r+1) || (*s && match(s+1, r));
-        case '.':  return (*(r+1)=='*' && *s) ? match(s, r+1) : match(s+1, r+1);
-        case '|':  return *r==*s ? match(s+1, r+1) : true;
-        default:   return (*r==*s && match(s+1, r+1));
+        case ALT_EXACT:  return len==alt->len && match_chars(s, alt->str, len);
+        case ALT_PREFIX: return len>=alt->len && match_chars(s, alt->str, alt->len);
+        case ALT_SUFFIX: return len>=alt->len && match_chars(s+len-alt->len, alt->str, alt->len);
+        default:         return match_glob(s, alt->str);
     }
 }
 
-/* fullname爲真時無序插入，否則按升序插入 */
-static void add_file(Strings *head, const char *path, const char *filename, bool fullname)
+// 比較s和r的前n個字符，r中的.匹配任一字符
+static bool match_chars(const char *s, const char *r, size_t n)
 {
-    Strings *file=create_file_node(path, filename, fullname);
-    Strings *ip=get_file_insert_point(head, file, !fullname);
-    LIST_ADD(file, ip);
+    for(size_t i=0; i<n; i++)
+        if(r[i]!='.' && r[i]!=s[i])
+            return false;
+    return true;
 }
 
-static Strings *create_file_node(const char *path, const char *filename, bool fullname)
+/* 不遞歸的通配符匹配：失配時只回溯到最近的*，故最壞情況下的耗時只與
+ * strlen(s)*strlen(r)成正比，不會隨*的數量指數增長 */
+static bool match_glob(const char *s, const char *r)
 {
-    Strings *file=Malloc(sizeof(Strings));
-    file->str = fullname ? copy_strings(path, "/", filename, NULL) : copy_string(filename);
-    return file;
+    const char *star=NULL, *ss=NULL;
+
+    while(*s)
+    {
+        if(*r == '*')
+            star=r++, ss=s;
+        else if(*r && (*r=='.' || *r==*s))
+            r++, s++;
+        else if(star)
+            r=star+1, s=++ss;
+        else
+            return false;
+    }
+    while(*r == '*')
+        r++;
+
+    return !*r;
 }
 
-static Strings *get_file_insert_point(Strings *head, Strings *file, bool order)
+static void add_file(Files *files, const char *path, const char *filename, bool fullname)
 {
-    if(!order)
-        return head;
+    if(files->n == files->size)
+    {
+        files->size = files->size ? 2*files->size : 256;
+        char **p=realloc(files->names, files->size*sizeof(char *));
+        if(p == NULL)
+            exit_with_msg(_("錯誤：申請內存失敗"));
+        files->names=p;
+    }
+    files->names[files->n++] = fullname ?
+        copy_strings(path, "/", filename, NULL) : copy_string(filename);
+}
+
+/* 收集完畢後纔一次性排序，再轉換爲鏈表。文件名的所有權轉移給鏈表 */
+static Strings *files_to_strings(Files *files)
+{
+    Strings *head=Malloc(sizeof(Strings));
 
-    LIST_FOR_EACH(Strings, p, head)
-        if(cmp_basename(file->str, p->str) <= 0)
-            return LIST_PREV(Strings, p);
+    LIST_INIT(head);
+    qsort(files->names, files->n, sizeof(char *), cmp_basename);
+    for(size_t i=0; i<files->n; i++)
+    {
+        Strings *file=Malloc(sizeof(Strings));
+        file->str=files->names[i];
+        LIST_ADD_TAIL(file, head);
+    }
+    Free(files->names);
 
-    return LIST_PREV(Strings, head);
+    return head;
 }
 
-static int cmp_basename(const char *s1, const char *s2)
+static int cmp_basename(const void *p1, const void *p2)
 {
-    const char *p1=strrchr(s1, '/'), *p2=strrchr(s2, '/');
-    p1=(p1 ? p1+1 : s1), p2=(p2 ? p2+1 : s2);
-    return strcmp(p1, p2);
+    const char *s1=*(char *const *)p1, *s2=*(char *const *)p2,
+          *b1=strrchr(s1, '/'), *b2=strrchr(s2, '/');
+    b1=(b1 ? b1+1 : s1), b2=(b2 ? b2+1 : s2);
+    return strcmp(b1, b2);
 }
 
+/* 以posix_spawnp代替fork，從而不必複製gwm的頁表，啓動命令的耗時也就與gwm佔用
+ * 的內存無關。gwm自己打開的文件描述符均設置了FD_CLOEXEC，不會泄漏給命令 */
 void exec_cmd(char *const cmd[])
 {
-    pid_t pid=fork();
-	if(pid == 0)
-    {
-		if(xinfo.display)
-            close(ConnectionNumber(xinfo.display));
-		if(!setsid())
-            perror(_("未能成功地爲命令創建新會話"));
-		if(execvp(cmd[0], cmd) == -1)
-            exit_with_perror(_("命令執行錯誤"));
-    }
-    else if(pid == -1)
-        perror(_("未能成功地爲命令創建新進程"));
+    pid_t pid;
+    sigset_t sigs;
+    posix_spawnattr_t attr;
+    int signums[]={SIGCHLD, SIGINT, SIGTERM, SIGQUIT, SIGHUP}; // gwm改變過處置方式的信號
+
+    sigemptyset(&sigs);
+    for(size_t i=0; i<ARRAY_NUM(signums); i++)
+        sigaddset(&sigs, signums[i]);
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setsigdefault(&attr, &sigs);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID|POSIX_SPAWN_SETSIGDEF);
+
+    int err=posix_spawnp(&pid, cmd[0], NULL, &attr, cmd, environ);
+    if(err)
+        errno=err, perror(_("命令執行錯誤"));
+    else
+        add_child(pid);
+    posix_spawnattr_destroy(&attr);
 }
 
 void exec_autostart(void)
@@ -162,3 +340,18 @@ bool is_accessible(const char *filename)
     struct stat buf;
     return !stat(filename, &buf);
 }
+
+/* 逐級創建目錄，類似於mkdir -p */
+bool make_dirs(const char *path)
+{
+    char *dir=copy_string(path);
+    bool result=true;
+
+    for(char *p=dir+1; result && *p; p++)
+        if(*p == '/')
+            *p='\0', result=(!mkdir(dir, 0700) || errno==EEXIST), *p='/';
+    result = result && (!mkdir(dir, 0700) || errno==EEXIST);
+    Free(dir);
+
+    return result;
+}
@@ -16,9 +16,10 @@
 
 #define SH_CMD(cmd_str) ((char *const []){"/bin/sh", "-c", (char *const)cmd_str, NULL})
 
-Strings *get_files_in_paths(const char *paths, const char *regex, bool fullname);
+Strings *get_files_in_paths(const char *paths, const char *regex, bool fullname, int max_depth);
 void exec_cmd(char *const cmd[]);
 void exec_autostart(void);
 bool is_accessible(const char *filename);
+bool make_dirs(const char *path);
 
 #endif
@@ -9,8 +9,10 @@
  * <http://www.gnu.org/licenses/>。
  * ************************************************************************/
 
+#include "config.h"
 #include "misc.h"
 #include "icccm.h"
+#include "trace.h"
 #include "focus.h"
 
 static void update_focus_client_pointer(Client *c);
@@ -20,16 +22,30 @@ static Client *get_first_map_diff_client(Client *key);
 static void set_all_net_client_list(void);
 static Window *get_client_win_list(int *n);
 static Window *get_client_win_list_stacking(int *n);
+static long get_enter_focus_elapsed_ms(void);
 
 // 分別爲各桌面的當前聚焦結點、前一個聚焦結點数组
 static Client *cur_focus_client[DESKTOP_N]={NULL};
 static Client *prev_focus_client[DESKTOP_N]={NULL};
 
+/* 布局、移動、提升窗口時，定位器雖未移動，其所在的窗口卻可能改變，從而產生
+ * 穿越事件。wm_crossing_serial是最後一個此類請求的序號，序號不大於它的穿越
+ * 事件即由本窗口管理器引發，不應據此改變聚焦。enter_focus_win是定位器最近進
+ * 入、尚待聚焦的窗口，定位器停留cfg->enter_focus_delay毫秒後才聚焦，以免快速
+ * 掠過多個窗口時反復聚焦 */
+static unsigned long wm_crossing_serial=0;
+static bool noop_pending=false; // 是否尚待發送空操作請求
+static Window enter_focus_win=None;
+static uint64_t enter_focus_time; // 進入enter_focus_win的時刻（單調時鐘的微秒數）
+
 /* 若在調用本函數之前cur_focus_client或prev_focus_client因某些原因（如移動到
  * 其他虛擬桌面、刪除、縮微）而未更新時，則應使用值爲NULL的c來調用本函數。這
  * 樣會自動推斷出合適的規則來取消原聚焦和聚焦新的client。*/
 void focus_client(Client *c)
 {
+    Window win = c ? WIDGET_WIN(c) : None;
+
+    TRACE_BEGIN("focus_client", win);
     update_focus_client_pointer(c);
 
     Client *pc=get_cur_focus_client(), *pp=get_prev_focus_client();
@@ -54,6 +70,7 @@ void focus_client(Client *c)
 
     set_net_active_window(pc ? WIDGET_WIN(pc) : None);
     set_all_net_client_list();
+    TRACE_END("focus_client", win);
 }
 
 void set_cur_focus_client(Client *c)
@@ -195,3 +212,69 @@ static Window *get_client_win_list_stacking(int *n)
 
     return wlist;
 }
+
+/* 在引發穿越事件的請求之後調用，只記下序號，由flush_wm_crossing_serial在本輪
+ * 事件循環結束時補發至多一個空操作請求。僅定位器聚焦模式需要區分穿越事件 */
+void ignore_wm_crossing_events(void)
+{
+    if(cfg->focus_mode != ENTER_FOCUS)
+        return;
+
+    wm_crossing_serial=NextRequest(xinfo.display)-1;
+    noop_pending=true;
+}
+
+/* 在主事件循環等待事件前調用，由wait_for_events發出請求。空操作請求使服務器處理完引發穿越事件的請求後，
+ * 由用戶操作產生的穿越事件的序號即大於wm_crossing_serial。若其後已發出了其他
+ * 請求，則不必再發 */
+void flush_wm_crossing_serial(void)
+{
+    if(noop_pending && NextRequest(xinfo.display)-1==wm_crossing_serial)
+        XNoOp(xinfo.display);
+    noop_pending=false;
+}
+
+bool is_wm_crossing_event(const XCrossingEvent *e)
+{
+    return e->mode!=NotifyNormal || (long)(e->serial-wm_crossing_serial)<=0;
+}
+
+/* c爲NULL表示定位器已離開客戶窗口，取消待定的聚焦 */
+void request_enter_focus(Client *c)
+{
+    enter_focus_win=None;
+    if(!c || c==get_cur_focus_client())
+        return;
+
+    if(cfg->enter_focus_delay <= 0)
+        focus_client(c);
+    else
+    {
+        enter_focus_win=WIDGET_WIN(c);
+        enter_focus_time=get_monotonic_us();
+    }
+}
+
+/* 返回距離待定聚焦生效的毫秒數，無待定聚焦時返回-1 */
+int get_enter_focus_timeout(void)
+{
+    if(!enter_focus_win)
+        return -1;
+    return MAX(cfg->enter_focus_delay-get_enter_focus_elapsed_ms(), 0);
+}
+
+static long get_enter_focus_elapsed_ms(void)
+{
+    return (get_monotonic_us()-enter_focus_time)/1000;
+}
+
+void handle_enter_focus_timeout(void)
+{
+    if(!enter_focus_win || get_enter_focus_elapsed_ms()<cfg->enter_focus_delay)
+        return;
+
+    Client *c=win_to_client(enter_focus_win);
+    enter_focus_win=None;
+    if(c && cfg->focus_mode==ENTER_FOCUS)
+        focus_client(c);
+}
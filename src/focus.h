@@ -21,5 +21,11 @@ void set_cur_focus_client(Client *c);
 Client *get_cur_focus_client(void);
 void set_prev_focus_client(Client *c);
 Client *get_prev_focus_client(void);
+void ignore_wm_crossing_events(void);
+void flush_wm_crossing_serial(void);
+bool is_wm_crossing_event(const XCrossingEvent *e);
+void request_enter_focus(Client *c);
+int get_enter_focus_timeout(void);
+void handle_enter_focus_timeout(void);
 
 #endif
@@ -16,6 +16,8 @@
 #include "config.h"
 #include "misc.h"
 #include "list.h"
+#include "trace.h"
+#include "xres.h"
 #include "font.h"
 
 typedef struct
@@ -121,27 +123,34 @@ void draw_string(Drawable d, const char *str, const Str_fmt *f)
     if(!str)
         return;
 
+    TRACE_BEGIN("draw_string", d);
     int x=f->x, y=f->y, w=f->w, h=f->h, sx, sy, sw, sh;
 
     get_str_rect_by_fmt(f, str, &sx, &sy, &sw, &sh);
-    XClearArea(xinfo.display, d, x, y, w, h, False); 
+    // 填充背景時不必先清除，且pixmap不能用XClearArea清除
     if(f->change_bg)
     {
-        GC gc=XCreateGC(xinfo.display, d, 0, NULL);
+        GC gc=get_depth_gc(xinfo.depth);
         XSetForeground(xinfo.display, gc, f->bg);
         XFillRectangle(xinfo.display, d, gc, x, y, w, h);
     }
+    else
+        XClearArea(xinfo.display, d, x, y, w, h, False);
 
     int len;
     uint32_t codepoint;
-    XftDraw *draw=XftDrawCreate(xinfo.display, d, xinfo.visual, xinfo.colormap);
+    XftDraw *draw=create_xft_draw(d, "font");
+    // 填充背景的區域通常是獨占的格子，故把字符串限制在區域內，以免畫到相鄰區域上
+    if(f->change_bg)
+        XftDrawSetClipRectangles(draw, 0, 0, &(XRectangle){x, y, w, h}, 1);
     while(*str)
     {
         len=get_utf8_codepoint(str, &codepoint);
         sx+=draw_utf8_char(draw, &f->fg, codepoint, len, (const FcChar8 *)str, sx, sy);
         str+=len;
     }
-    XftDrawDestroy(draw);
+    destroy_xft_draw(draw);
+    TRACE_END("draw_string", d);
 }
 
 /* libXrender文檔沒有解釋XGlyphInfo結構體成員的含義。 猜測xOff指字符串原點到
@@ -211,6 +220,7 @@ static void get_str_rect_by_fmt(const Str_fmt *f, const char *str, int *x, int *
         case BOTTOM_LEFT: *x=left, *y=bottom; break;
         case BOTTOM_CENTER: *x=cx, *y=bottom; break;
         case BOTTOM_RIGHT: *x=right, *y=bottom; break;
+        default: *x=cx, *y=cy; break;
     }
     if(*w+2*pad>f->w)
         *x=left;
@@ -12,6 +12,7 @@
 #include "misc.h"
 #include "button.h"
 #include "config.h"
+#include "ewmh.h"
 #include "prop.h"
 #include "icccm.h"
 #include "tooltip.h"
@@ -20,6 +21,12 @@
 #define FRAME_EVENT_MASK (SubstructureRedirectMask|SubstructureNotifyMask| \
     ExposureMask|ButtonPressMask|CROSSING_MASK|FocusChangeMask)
 #define TITLEBAR_EVENT_MASK (BUTTON_MASK|ExposureMask|CROSSING_MASK)
+#define FRAME_POOL_SIZE 4 // 回收池最多保存的框架數
+
+/* 創建和銷毀一個帶標題欄的框架要創建和銷毀十幾個窗口及其提示窗口、菜單等。
+ * 頻繁打開和關閉對話框的程序會使這些工作反復進行，故把刪除的框架連同其窗口
+ * 樹取消映射後放入容量有限的回收池，創建框架時優先取出尺寸規格相同者，只需
+ * 更換標題、圖標並調整位置和尺寸 */
 
 struct _titlebar_tag // 標題欄
 {
@@ -50,20 +57,27 @@ static void titlebar_buttons_show(Titlebar *titlebar);
 static int titlebar_get_button_n(void);
 static Rect titlebar_get_button_rect(const Titlebar *titlebar, size_t index);
 static Rect titlebar_get_title_rect(const Titlebar *titlebar);
+static Frame *take_pooled_frame(int titlebar_h, int border_w);
+static void frame_reuse(Frame *frame, Widget *parent, int x, int y, int w, int h, const char *title, Imlib_Image image);
+static void titlebar_reuse(Titlebar *titlebar, const char *title, Imlib_Image image);
+static bool pool_frame(Frame *frame);
+
+static Frame *frame_pool[FRAME_POOL_SIZE]; // 框架回收池
+static int frame_pool_n=0; // 回收池中的框架數
 
 Frame *frame_new(Widget *parent, int x, int y, int w, int h, int titlebar_h, int border_w, const char *title, Imlib_Image image)
 {
-    Frame *frame=Malloc(sizeof(Frame));
-    frame_ctor(frame, parent, x, y, w, h, titlebar_h, border_w, title, image);
-    XSelectInput(xinfo.display, WIDGET_WIN(frame), FRAME_EVENT_MASK);
-    
-    /* 以下是同時設置窗口前景和背景透明度的非EWMH標準方法：
-    unsigned long opacity = (unsigned long)(0xfffffffful);
-    Atom XA_NET_WM_WINDOW_OPACITY = XInternAtom(xinfo.display, "_NET_WM_WINDOW_OPACITY", False);
-    XChangeProperty(xinfo.display, c->frame, XA_NET_WM_WINDOW_OPACITY, XA_CARDINAL, 32,
-        PropModeReplace, (unsigned char *)&opacity, 1L);
-    */
+    Frame *frame=take_pooled_frame(titlebar_h, border_w);
+    if(frame)
+        frame_reuse(frame, parent, x, y, w, h, title, image);
+    else
+    {
+        frame=Malloc(sizeof(Frame));
+        frame_ctor(frame, parent, x, y, w, h, titlebar_h, border_w, title, image);
+        XSelectInput(xinfo.display, WIDGET_WIN(frame), FRAME_EVENT_MASK);
+    }
 
+    // 客戶窗口的_NET_WM_WINDOW_OPACITY由合成器直接讀取，不必複製到框架
     XAddToSaveSet(xinfo.display, frame->cwin);
     XReparentWindow(xinfo.display, frame->cwin, WIDGET_WIN(frame), 0, titlebar_h);
     set_client_leader(frame->cwin, WIDGET_WIN(frame));
@@ -85,6 +99,52 @@ static void frame_ctor(Frame *frame, Widget *parent, int x, int y, int w, int h,
         frame->titlebar=titlebar_new(WIDGET(frame), 0, 0, w, titlebar_h, title, image);
 }
 
+static Frame *take_pooled_frame(int titlebar_h, int border_w)
+{
+    for(int i=frame_pool_n-1; i>=0; i--)
+    {
+        Frame *frame=frame_pool[i];
+        if( frame_get_titlebar_height(frame)==titlebar_h
+            && WIDGET_BORDER_W(frame)==border_w)
+        {
+            frame_pool[i]=frame_pool[--frame_pool_n];
+            return frame;
+        }
+    }
+    return NULL;
+}
+
+static void frame_reuse(Frame *frame, Widget *parent, int x, int y, int w, int h, const char *title, Imlib_Image image)
+{
+    frame->cwin=WIDGET_WIN(parent);
+    widget_set_state(WIDGET(frame), (Widget_state){0});
+    widget_set_border_color(WIDGET(frame), get_widget_color(WIDGET(frame)));
+    if(cfg->set_frame_prop)
+        copy_prop(WIDGET_WIN(frame), frame->cwin);
+    if(frame->titlebar)
+        titlebar_reuse(frame->titlebar, title, image);
+    frame_move_resize(frame, x, y, w, h);
+}
+
+/* 重置上一個客戶遺留的懸停、警告等狀態，並按當前布局顯示按鈕 */
+static void titlebar_reuse(Titlebar *titlebar, const char *title, Imlib_Image image)
+{
+    Widget_state state={0};
+
+    Free(titlebar->title);
+    titlebar->title=copy_string(title);
+    tooltip_change_tip(TOOLTIP(WIDGET_TOOLTIP(titlebar)), title);
+    if(image)
+        button_set_icon(titlebar->logo, image, NULL, NULL);
+    else
+        button_change_icon(titlebar->logo, NULL, NULL, "∨");
+    widget_set_state(WIDGET(titlebar), state);
+    widget_set_state(WIDGET(titlebar->logo), state);
+    for(size_t i=0; i<TITLE_BUTTON_N; i++)
+        widget_set_state(WIDGET(titlebar->buttons[i]), state);
+    titlebar_buttons_show(titlebar);
+}
+
 static Titlebar *titlebar_new(Widget *parent, int x, int y, int w, int h, const char *title, Imlib_Image image)
 {
     Titlebar *titlebar=Malloc(sizeof(Titlebar));
@@ -152,10 +212,45 @@ void frame_del(Frame *frame)
 
     XReparentWindow(xinfo.display, frame->cwin, xinfo.root_win, 
         WIDGET_X(frame)+bw, WIDGET_Y(frame)+th+bw);
+    if(pool_frame(frame))
+        return;
     frame_dtor(frame);
     widget_del(WIDGET(frame));
 }
 
+/* 取消映射並清除上一個客戶的痕跡後放入回收池，池滿時返回false */
+static bool pool_frame(Frame *frame)
+{
+    if(frame_pool_n == FRAME_POOL_SIZE)
+        return false;
+
+    widget_hide(WIDGET(frame));
+    frame->cwin=None;
+    /* 刪除客戶時若正處於全屏模式，leave_fullscreen_mode已無法據客戶找到框架，
+     * 故須在此刪除全屏模式給框架設置的特性 */
+    if(cfg->set_frame_prop)
+        delete_all_props(WIDGET_WIN(frame));
+    else
+        set_net_wm_bypass_compositor(WIDGET_WIN(frame), 0);
+    if(frame->titlebar)
+    {
+        button_drop_image(frame->titlebar->logo);
+        widget_hide(WIDGET(frame->titlebar->menu));
+    }
+    frame_pool[frame_pool_n++]=frame;
+    return true;
+}
+
+void free_frame_pool(void)
+{
+    while(frame_pool_n)
+    {
+        Frame *frame=frame_pool[--frame_pool_n];
+        frame_dtor(frame);
+        widget_del(WIDGET(frame));
+    }
+}
+
 static void frame_dtor(Frame *frame)
 {
     if(frame->titlebar)
@@ -22,6 +22,7 @@ typedef struct rectangle_tag Rect;
 
 Frame *frame_new(Widget *parent, int x, int y, int w, int h, int titlebar_h, int border_w, const char *title, Imlib_Image image);
 void frame_del(Frame *frame);
+void free_frame_pool(void);
 void frame_move_resize(Frame *frame, int x, int y, int w, int h);
 bool frame_has_win(const Frame *frame, Window win);
 void frame_set_state_unfocused(Frame *frame, int value);
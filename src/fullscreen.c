@@ -0,0 +1,130 @@
+/* *************************************************************************
+ *     fullscreen.c：實現全屏模式下暫停非必要工作的功能。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include <string.h>
+#include "config.h"
+#include "client.h"
+#include "ewmh.h"
+#include "prop.h"
+#include "taskbar.h"
+#include "misc.h"
+#include "fullscreen.h"
+
+/* 當前桌面有全屏窗口時，它遮住了任務欄等構件，遊戲、視頻等全屏程序又對幀
+ * 間隔很敏感。此時進入全屏模式：設置_NET_WM_BYPASS_COMPOSITOR以便合成器停止
+ * 重定向該窗口，暫停任務欄的更新，推遲把客戶窗口特性複製到框架。離開全屏模式
+ * 時恢復原狀並補上推遲的工作 */
+typedef struct // 推遲複製到框架的特性
+{
+    Window win; // 客戶窗口
+    Atom atom; // 特性
+} Deferred_prop;
+
+static Window fullscreen_win=None; // 全屏模式所針對的客戶窗口
+static bool bypass_client=false; // 是否給客戶窗口設置了_NET_WM_BYPASS_COMPOSITOR
+static Deferred_prop *deferred_props=NULL;
+static size_t deferred_n=0, deferred_size=0;
+
+static Client *find_fullscreen_client(void);
+static void enter_fullscreen_mode(Client *c);
+static void leave_fullscreen_mode(void);
+static void copy_deferred_frame_props(void);
+
+/* 在布局更新後調用，以便涵蓋窗口進出全屏層、切換桌面、縮微及刪除等情況 */
+void update_fullscreen_mode(void)
+{
+    Client *c=find_fullscreen_client();
+    Window win = c ? WIDGET_WIN(c) : None;
+
+    if(win == fullscreen_win)
+        return;
+    if(fullscreen_win)
+        leave_fullscreen_mode();
+    if(c)
+        enter_fullscreen_mode(c);
+}
+
+static Client *find_fullscreen_client(void)
+{
+    clients_for_each(c)
+        if( c->layer==FULLSCREEN_LAYER && is_on_cur_desktop(c)
+            && !is_iconic_client(c))
+            return c;
+    return NULL;
+}
+
+/* 若客戶明確要求不停止重定向（值爲2），則尊重其要求；若客戶未設置，則由本
+ * 程序代爲設置，離開全屏模式時再刪除 */
+static void enter_fullscreen_mode(Client *c)
+{
+    long bypass=get_net_wm_bypass_compositor(WIDGET_WIN(c));
+
+    fullscreen_win=WIDGET_WIN(c);
+    if(bypass != 2)
+    {
+        set_net_wm_bypass_compositor(WIDGET_WIN(c->frame), 1);
+        if(!bypass)
+            set_net_wm_bypass_compositor(WIDGET_WIN(c), 1), bypass_client=true;
+    }
+    taskbar_set_frozen(true);
+}
+
+static void leave_fullscreen_mode(void)
+{
+    Client *c=win_to_client(fullscreen_win);
+
+    if(c)
+    {
+        set_net_wm_bypass_compositor(WIDGET_WIN(c->frame), 0);
+        if(bypass_client)
+            set_net_wm_bypass_compositor(WIDGET_WIN(c), 0);
+    }
+    fullscreen_win=None;
+    bypass_client=false;
+    taskbar_set_frozen(false);
+    copy_deferred_frame_props();
+}
+
+bool is_fullscreen_mode(void)
+{
+    return fullscreen_win;
+}
+
+/* 全屏模式下客戶窗口特性的變化暫不複製到框架，只記下窗口和特性 */
+void defer_frame_prop(Window win, Atom atom)
+{
+    for(size_t i=0; i<deferred_n; i++)
+        if(deferred_props[i].win==win && deferred_props[i].atom==atom)
+            return;
+
+    if(deferred_n == deferred_size)
+    {
+        deferred_size = deferred_size ? deferred_size*2 : 16;
+        Deferred_prop *p=Malloc(deferred_size*sizeof(Deferred_prop));
+        if(deferred_n)
+            memcpy(p, deferred_props, deferred_n*sizeof(Deferred_prop));
+        Free(deferred_props);
+        deferred_props=p;
+    }
+    deferred_props[deferred_n++]=(Deferred_prop){win, atom};
+}
+
+static void copy_deferred_frame_props(void)
+{
+    for(size_t i=0; i<deferred_n; i++)
+    {
+        Client *c=win_to_client(deferred_props[i].win);
+        if(c)
+            copy_spec_prop(WIDGET_WIN(c->frame), WIDGET_WIN(c),
+                deferred_props[i].atom);
+    }
+    deferred_n=0;
+}
@@ -25,6 +25,8 @@
 #include "grab.h"
 #include "taskbar.h"
 #include "gui.h"
+#include "screenshot.h"
+#include "compositor.h"
 #include "func.h"
 
 /* ========================== Func函數命名風格 =============================
@@ -204,7 +206,14 @@ void toggle_compositor(XEvent *e, Arg arg)
     UNUSED(e), UNUSED(arg);
     Window win=get_compositor();
 
-    if(win)
+    if(cfg->builtin_compositor)
+    {
+        if(is_compositor_running())
+            stop_compositor();
+        else
+            start_compositor();
+    }
+    else if(win)
         XKillClient(xinfo.display, win);
     else
         exec_cmd(SH_CMD(cfg->compositor));
@@ -222,6 +231,14 @@ void deiconify(XEvent *e, Arg arg)
     deiconify_client(get_cur_focus_client()); 
 }
 
+/* arg.n爲0時翻到下一頁。由定位器按鈕觸發時，僅當按在溢出指示區上纔翻頁 */
+void scroll_iconbar(XEvent *e, Arg arg)
+{
+    if(!arg.n && e->type==ButtonPress && !taskbar_is_on_iconbar_more(e->xbutton.x))
+        return;
+    taskbar_scroll_iconbar(arg.n);
+}
+
 void toggle_max_restore(XEvent *e, Arg arg)
 {
     UNUSED(e), UNUSED(arg);
@@ -334,13 +351,25 @@ void rise_height(XEvent *e, Arg arg)
 void move(XEvent *e, Arg arg)
 {
     UNUSED(arg);
-    pointer_move_resize_client(e, false);
+    pointer_move_resize_client(e, false, false);
 }
 
 void resize(XEvent *e, Arg arg)
 {
     UNUSED(arg);
-    pointer_move_resize_client(e, true);
+    pointer_move_resize_client(e, true, false);
+}
+
+void outline_move(XEvent *e, Arg arg)
+{
+    UNUSED(arg);
+    pointer_move_resize_client(e, false, true);
+}
+
+void outline_resize(XEvent *e, Arg arg)
+{
+    UNUSED(arg);
+    pointer_move_resize_client(e, true, true);
 }
 
 void toggle_shade(XEvent *e, Arg arg)
@@ -49,6 +49,7 @@ void print_win(XEvent *e, Arg arg);
 void toggle_compositor(XEvent *e, Arg arg);
 void mini(XEvent *e, Arg arg);
 void deiconify(XEvent *e, Arg arg);
+void scroll_iconbar(XEvent *e, Arg arg);
 void toggle_max_restore(XEvent *e, Arg arg);
 void vmax(XEvent *e, Arg arg);
 void hmax(XEvent *e, Arg arg);
@@ -68,6 +69,8 @@ void fall_height(XEvent *e, Arg arg);
 void rise_height(XEvent *e, Arg arg);
 void move(XEvent *e, Arg arg);
 void resize(XEvent *e, Arg arg);
+void outline_move(XEvent *e, Arg arg);
+void outline_resize(XEvent *e, Arg arg);
 void toggle_shade(XEvent *e, Arg arg);
 void change_place(XEvent *e, Arg arg);
 void to_main_area(XEvent *e, Arg arg);
@@ -12,6 +12,7 @@
 #include <X11/Xutil.h>
 #include "misc.h"
 #include "config.h"
+#include "xres.h"
 #include "grab.h"
 
 static unsigned int get_num_lock_mask(void);
@@ -96,7 +97,7 @@ void grab_buttons(Window win, Widget_id id)
 void create_cursors(void)
 {
     for(size_t i=0; i<POINTER_ACT_N; i++)
-        cursors[i]=XCreateFontCursor(xinfo.display, cfg->cursor_shape[i]);
+        cursors[i]=create_font_cursor(cfg->cursor_shape[i], "cursor");
 }
 
 void set_cursor(Window win, Pointer_act act)
@@ -107,5 +108,5 @@ void set_cursor(Window win, Pointer_act act)
 void free_cursors(void)
 {
     for(size_t i=0; i<POINTER_ACT_N; i++)
-        XFreeCursor(xinfo.display, cursors[i]);
+        free_cursor(cursors[i]);
 }
@@ -18,6 +18,7 @@ typedef union // 要綁定的函數的參數類型
 {
     char *const *cmd; // 命令字符串
     unsigned int desktop_n; // 虛擬桌面編號，從0開始編號
+    int n; // 數量，如縮微窗口欄滾動的按鈕數
 } Arg;
 
 typedef void (*Func)(XEvent *, Arg); // 要綁定的函數類型
@@ -9,6 +9,7 @@
  * <http://www.gnu.org/licenses/>。
  * ************************************************************************/
 
+#include <limits.h>
 #include "gwm.h"
 #include "config.h"
 #include "client.h"
@@ -21,16 +22,21 @@
 #include "misc.h"
 #include "grab.h"
 #include "wallpaper.h"
+#include "cmdindex.h"
+#include "screenshot.h"
+#include "sizehintwin.h"
 #include "gui.h"
 
+#define CMD_COMPLETION_PAGE_N 4 // 每次查詢時取出的補全結果頁數
+
 static void create_taskbar(void);
 static void create_cmd_entry(Widget_id id);
 static Strings *entry_get_cmd_completion(Entry *entry);
-static char *entry_get_part_match_regex(Entry *entry);
 static void create_color_entry(Widget_id id);
 
 Entry *cmd_entry=NULL; // 輸入命令並執行的構件
 Entry *color_entry=NULL; // 输入颜色名并设置颜色的構件
+static int cmd_completion_nmax=INT_MAX; // 命令補全列表可顯示的最大條目數
 
 void init_gui(void)
 {
@@ -41,18 +47,23 @@ void init_gui(void)
     init_wallpaper();
     set_default_wallpaper();
     create_taskbar();
+    init_screenshot();
+    init_cmd_index();
     create_cmd_entry(RUN_CMD_ENTRY);
     create_color_entry(COLOR_ENTRY);
 }
 
 void deinit_gui(void)
 {
+    deinit_screenshot();
     free_cursors();
     close_fonts();
     XClearWindow(xinfo.display, xinfo.root_win);
     free_wallpapers();
     taskbar_del();
+    free_size_hint_win();
     entry_del(cmd_entry);
+    deinit_cmd_index();
     entry_del(color_entry);
 }
 
@@ -77,17 +88,19 @@ void create_cmd_entry(Widget_id id)
 
     cmd_entry=entry_new(NULL, id, x, y, w, h, cfg->cmd_entry_hint,
         entry_get_cmd_completion);
-    listview_set_nmax(entry_get_listview(cmd_entry), (sh-y-h-h)/h);
+    cmd_completion_nmax=(sh-y-h-h)/h;
+    listview_set_nmax(entry_get_listview(cmd_entry), cmd_completion_nmax);
     widget_set_poppable(WIDGET(cmd_entry), true);
 }
 
+/* 列表視圖最多只顯示cmd_completion_nmax條，故只需取出若干頁補全結果，以便
+ * 用鍵盤滾動時不必重新查詢 */
 static Strings *entry_get_cmd_completion(Entry *entry)
 {
-    char *regex=entry_get_part_match_regex(entry);
-    char *paths=getenv("PATH");
-    Strings *cmds=get_files_in_paths(paths, regex, false);
-    Free(regex);
-    return cmds;
+    char text[FILENAME_MAX]={0};
+    wcstombs(text, entry_get_text(entry), FILENAME_MAX);
+    return get_cmd_completions(text,
+        (size_t)MAX(cmd_completion_nmax, 1)*CMD_COMPLETION_PAGE_N);
 }
 
 void create_color_entry(Widget_id id)
@@ -103,13 +116,6 @@ void create_color_entry(Widget_id id)
     widget_set_poppable(WIDGET(color_entry), true);
 }
 
-static char *entry_get_part_match_regex(Entry *entry)
-{
-    char text[FILENAME_MAX]={0};
-    wcstombs(text, entry_get_text(entry), FILENAME_MAX);
-    return copy_strings(text, ".*", NULL);
-}
-
 void open_color_settings(void)
 {
     entry_clear(color_entry);
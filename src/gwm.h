@@ -110,6 +110,7 @@ typedef struct // 窗口管理器的規則
     Area area; // 客戶窗口的區
     unsigned int desktop_mask; // 客戶窗口所属虚拟桌面掩碼
     bool follow_maxmin_hint; // 遵從最大和最小尺寸提示的標志
+    bool outline_mvresize; // 以輪廓方式移動和調整窗口尺寸的標志
 } Rule;
 
 typedef struct // 與X相關的信息
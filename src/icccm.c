@@ -192,19 +192,31 @@ bool has_focus_hint(const XWMHints *hint)
 
 bool send_wm_protocol_msg(Atom protocol, Window win)
 {
-    if(has_spec_wm_protocol(win, protocol))
-    {
-        XEvent event;
-        event.type=ClientMessage;
-        event.xclient.display=xinfo.display;
-        event.xclient.window=win;
-        event.xclient.message_type=icccm_atoms[WM_PROTOCOLS];
-        event.xclient.format=32;
-        event.xclient.data.l[0]=protocol;
-        event.xclient.data.l[1]=CurrentTime;
-        return XSendEvent(xinfo.display, win, False, NoEventMask, &event);
-    }
-    return false;
+    return send_wm_protocol_data_msg(protocol, win, 0, 0);
+}
+
+/* 有些協議（如_NET_WM_SYNC_REQUEST）需要在data.l[2]和data.l[3]附帶數據 */
+bool send_wm_protocol_data_msg(Atom protocol, Window win, long data2, long data3)
+{
+    return has_spec_wm_protocol(win, protocol)
+        && send_protocol_client_msg(protocol, win, data2, data3);
+}
+
+/* 不檢查客戶是否支持protocol，由調用者保證 */
+bool send_protocol_client_msg(Atom protocol, Window win, long data2, long data3)
+{
+    XEvent event;
+    event.type=ClientMessage;
+    event.xclient.display=xinfo.display;
+    event.xclient.window=win;
+    event.xclient.message_type=icccm_atoms[WM_PROTOCOLS];
+    event.xclient.format=32;
+    event.xclient.data.l[0]=protocol;
+    event.xclient.data.l[1]=CurrentTime;
+    event.xclient.data.l[2]=data2;
+    event.xclient.data.l[3]=data3;
+    event.xclient.data.l[4]=0;
+    return XSendEvent(xinfo.display, win, False, NoEventMask, &event);
 }
 
 bool has_spec_wm_protocol(Window win, Atom protocol)
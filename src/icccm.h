@@ -34,6 +34,8 @@ bool is_in_size_limit(int w, int h, const XSizeHints *hint);
 void set_input_focus(Window win, const XWMHints *hint);
 bool has_focus_hint(const XWMHints *hint);
 bool send_wm_protocol_msg(Atom protocol, Window win);
+bool send_wm_protocol_data_msg(Atom protocol, Window win, long data2, long data3);
+bool send_protocol_client_msg(Atom protocol, Window win, long data2, long data3);
 bool has_spec_wm_protocol(Window win, Atom protocol);
 void set_urgency_hint(Window win, XWMHints *h, bool urg);
 bool is_iconic_state(Window win);
@@ -14,12 +14,15 @@
 #include <limits.h>
 #include <X11/Xutil.h>
 #include <X11/Xproto.h>
+#include "config.h"
 #include "drawable.h"
 #include "ewmh.h"
 #include "file.h"
 #include "gwm.h"
 #include "misc.h"
 #include "list.h"
+#include "trace.h"
+#include "xres.h"
 #include "image.h"
 
 typedef struct image_node_tag
@@ -85,6 +88,7 @@ void free_image(Imlib_Image image)
 static void free_image_node(Image_node *node)
 {
     Free(node->name);
+    unreg_xres(XRES_IMAGE, (uintptr_t)node->image);
     imlib_context_set_image(node->image);
     imlib_free_image();
     LIST_DEL(node);
@@ -103,6 +107,9 @@ static void reg_image(const char *name, Imlib_Image image)
     }
     Image_node *p=create_image_node(name, image);
     LIST_ADD(p, image_list);
+    imlib_context_set_image(image);
+    reg_xres(XRES_IMAGE, (uintptr_t)image, "image",
+        (size_t)imlib_image_get_width()*imlib_image_get_height()*sizeof(DATA32));
 }
 
 static Image_node *create_image_node(const char *name, Imlib_Image image)
@@ -116,6 +123,12 @@ static Image_node *create_image_node(const char *name, Imlib_Image image)
 void draw_image(Imlib_Image image, Drawable d, int x, int y, int w, int h)
 {
     XClearArea(xinfo.display, d, x, y, w, h, False); 
+    render_image(image, d, x, y, w, h);
+}
+
+/* 與draw_image不同，不先清除繪製區域，故亦可畫在pixmap上 */
+void render_image(Imlib_Image image, Drawable d, int x, int y, int w, int h)
+{
     set_visual_for_imlib(d);
     imlib_context_set_image(image);
     imlib_context_set_drawable(d);   
@@ -130,11 +143,13 @@ Imlib_Image get_win_icon_image(Window win)
 
     Imlib_Image image=NULL;
     char *name = h.res_class ? h.res_class : h.res_name;
+    TRACE_BEGIN("get_win_icon_image", win);
     if( (image=search_icon_image(h.res_class))
         || (image=search_icon_image(h.res_name))
         || (image=create_icon_image_from_hint(win, name))
         || (image=create_icon_image_from_prop(win, name)))
         { ; }
+    TRACE_END("get_win_icon_image", win);
     XFree(h.res_class), XFree(h.res_name);
 
     return image;
@@ -190,22 +205,21 @@ static Imlib_Image create_icon_image_from_prop(Window win, const char *name)
     if(!win || !name)
         return NULL;
 
-    long *data=get_net_wm_icon(win);
+    int w=0, h=0;
+    uint32_t *data=get_net_wm_icon(win, cfg->icon_image_size, &w, &h);
     if(!data)
         return NULL;
     
-    long w=data[0], h=data[1], size=w*h, i;
     Imlib_Image image=imlib_create_image(w, h);
     if(image)
     {
         imlib_context_set_image(image);
         imlib_image_set_has_alpha(1);
-        /* imlib2和_NET_WM_ICON同樣使用大端字節序，因此不必轉換字節序 */
+        /* imlib2和_NET_WM_ICON同樣使用未預乘alpha的ARGB格式，因此可直接復制 */
         DATA32 *image_data=imlib_image_get_data();
         if(image_data)
         {
-            for(i=0; i<size; i++)
-                image_data[i]=data[i+2];
+            memcpy(image_data, data, (size_t)w*h*sizeof(DATA32));
             imlib_image_put_back_data(image_data);
         }
     }
@@ -309,7 +323,11 @@ static bool get_closest_icon(const char *name, int size, int scale, const char *
 
             int d=get_dir_size_distance(base_dir, theme, sub_dir, size, scale);
             if(d < *min_distance)
+            {
+                free(*closest);
                 *closest=f, *min_distance=d;
+                continue;
+            }
         }
         Free(f);
     }
@@ -11,7 +11,7 @@
 
 #include <locale.h>
 #include <signal.h>
-#include <sys/wait.h>
+#include <fcntl.h>
 #include "clientop.h"
 #include "misc.h"
 #include "config.h"
@@ -25,12 +25,18 @@
 #include "focus.h"
 #include "grab.h"
 #include "layout.h"
+#include "syncreq.h"
+#include "child.h"
+#include "evstats.h"
+#include "trace.h"
 #include "taskbar.h"
 #include "bind_cfg.h"
 #include "gui.h"
+#include "xres.h"
+#include "compositor.h"
+#include "ipc.h"
 #include "init.h"
 
-static void clear_zombies(int signum);
 static void open_display(void);
 static void init_X(void);
 static void set_visual_info(void);
@@ -45,11 +51,12 @@ static void ready_to_quit(int signum);
 
 void init_gwm(void)
 {
-    clear_zombies(0);
+    init_child_reaper();
     open_display();
     set_locale();
     init_X();
     set_atoms();
+    init_sync_request();
     create_layer_wins();
     config();
     correct_config();
@@ -57,21 +64,20 @@ void init_gwm(void)
     set_net_current_desktop(cfg->default_cur_desktop);
     init_event_handler(handle_x_event);
     set_ewmh();
+    init_compositor_owner();
     init_layout();
     reg_binds(keybinds, buttonbinds);
     init_gui();
     init_client_list();
     grab_keys();
+    init_ipc(); // 須先於自啓動腳本，以便其使用GWM_SOCKET
     exec_autostart();
     set_screensaver();
     set_signals();
-}
-
-static void clear_zombies(int signum)
-{
-    UNUSED(signum);
-	while(0 < waitpid(-1, NULL, WNOHANG))
-        ;
+    init_event_stats();
+    init_trace();
+    if(cfg->builtin_compositor)
+        start_compositor();
 }
 
 static void open_display(void)
@@ -79,6 +85,7 @@ static void open_display(void)
     xinfo.display=XOpenDisplay(NULL);
     if(xinfo.display == NULL)
         exit_with_msg("error: cannot open display");
+    fcntl(ConnectionNumber(xinfo.display), F_SETFD, FD_CLOEXEC); // 以免泄漏給命令
 }
 
 static void init_X(void)
@@ -187,17 +194,23 @@ static void init_imlib(void)
 void deinit_gwm(void)
 {
     XSetInputFocus(xinfo.display, xinfo.root_win, RevertToPointerRoot, CurrentTime);
+    stop_compositor();
     clients_for_each_safe(c)
         client_del(c);
+    free_frame_pool();
     free_all_images();
     deinit_gui();
     destroy_layer_wins();
+    free_depth_gcs();
     XFreeModifiermap(xinfo.mod_map);
     if(xinfo.xim)
         XCloseIM(xinfo.xim);
     XFlush(xinfo.display);
     XCloseDisplay(xinfo.display);
-    clear_zombies(0);
+    deinit_child_reaper();
+    deinit_trace();
+    deinit_ipc();
+    free_xres_table();
     Free(cfg);
 }
 
@@ -209,8 +222,6 @@ static void set_screensaver(void)
 
 static void set_signals(void)
 {
-	if(signal(SIGCHLD, clear_zombies) == SIG_ERR)
-        perror(_("不能安裝SIGCHLD信號處理函數"));
 	if(signal(SIGINT, ready_to_quit) == SIG_ERR)
         perror(_("不能安裝SIGINT信號處理函數"));
 	if(signal(SIGTERM, ready_to_quit) == SIG_ERR)
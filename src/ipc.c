@@ -0,0 +1,620 @@
+/* *************************************************************************
+ *     ipc.c：實現經由Unix域套接字控制和查詢gwm的功能。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#define _GNU_SOURCE // 爲了使用accept4
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "config.h"
+#include "clientop.h"
+#include "desktop.h"
+#include "evstats.h"
+#include "file.h"
+#include "focus.h"
+#include "func.h"
+#include "gui.h"
+#include "layout.h"
+#include "prop.h"
+#include "trace.h"
+#include "xres.h"
+#include "ipc.h"
+
+/* 協議以行爲單位：每行一個命令，格式爲“命令名 [參數]”。每個命令的答復爲零
+ * 或多行數據，再以“ok”或“error: 原因”一行結束。begin與commit之間的命令先
+ * 暫存，收到commit時一併執行。所有客戶在一輪poll中發來的命令執行完後纔統一
+ * 重新布局一次，故腳本可高頻地發送命令而無需經由X服務器往返 */
+#define IPC_CLIENT_MAX 16 // 同時連接的客戶數上限
+#define IPC_LINE_MAX 4096 // 命令行的長度上限（含換行符）
+#define IPC_BATCH_MAX 256 // 一批暫存命令的數量上限
+#define IPC_OUT_MAX (1<<20) // 未發送答復的字節數上限，超過時斷開該客戶
+
+typedef enum // 動作的參數類型
+{
+    IPC_NO_ARG, IPC_DESKTOP_ARG, IPC_N_ARG, IPC_CMD_ARG,
+} Ipc_arg_type;
+
+typedef struct // 可經由IPC調用的Func函數
+{
+    const char *name;
+    Func func;
+    Ipc_arg_type arg_type;
+    bool need_client; // 是否須有當前聚焦的客戶窗口
+} Ipc_action;
+
+typedef struct // IPC查詢命令，返回NULL表示成功，否則返回錯誤原因
+{
+    const char *name;
+    const char *(*func)(FILE *fp, const char *arg);
+} Ipc_query;
+
+typedef struct // 已連接的IPC客戶
+{
+    int fd;
+    char in[IPC_LINE_MAX]; // 尚未構成完整一行的輸入
+    size_t in_len;
+    char *out; // 尚未發送的答復
+    size_t out_len, out_size;
+    bool in_batch; // 是否處於begin與commit之間
+    char *batch[IPC_BATCH_MAX]; // 暫存的命令
+    size_t batch_n;
+} Ipc_client;
+
+static const char *query_clients(FILE *fp, const char *arg);
+static const char *query_client(FILE *fp, const char *arg);
+static const char *query_focus(FILE *fp, const char *arg);
+static const char *query_desktop(FILE *fp, const char *arg);
+static const char *query_layout(FILE *fp, const char *arg);
+static const char *query_evstats(FILE *fp, const char *arg);
+static const char *query_xres(FILE *fp, const char *arg);
+static const char *query_trace(FILE *fp, const char *arg);
+static const char *cmd_focus(FILE *fp, const char *arg);
+static const char *cmd_color(FILE *fp, const char *arg);
+static char *get_ipc_socket_path(void);
+static int open_ipc_socket(const char *path);
+static void accept_ipc_clients(void);
+static bool add_ipc_client(int fd);
+static void del_ipc_client(size_t i);
+static bool read_ipc_client(Ipc_client *ic);
+static void handle_ipc_line(Ipc_client *ic, FILE *fp, char *line);
+static void commit_ipc_batch(Ipc_client *ic, FILE *fp);
+static void clear_ipc_batch(Ipc_client *ic);
+static void run_ipc_cmd(FILE *fp, char *line);
+static char *split_ipc_cmd(char *line, char **arg);
+static const char *run_ipc_action(const Ipc_action *a, const char *arg);
+static bool parse_desktop_n(const char *arg, unsigned int *n);
+static bool parse_win(const char *arg, Window *win);
+static void print_client_info(FILE *fp, const Client *c);
+static bool append_ipc_output(Ipc_client *ic, const char *s, size_t n);
+static bool flush_ipc_client(Ipc_client *ic);
+
+/* 需要真實的定位器或按鍵事件的函數（如move、resize、move_up等）不能經由
+ * IPC調用，故未列入 */
+static const Ipc_action actions[]=
+{
+    {"exec",                   exec,                   IPC_CMD_ARG,     false},
+    {"quit_wm",                quit_wm,                IPC_NO_ARG,      false},
+    {"quit",                   quit,                   IPC_NO_ARG,      true},
+    {"quit_all",               quit_all,               IPC_NO_ARG,      false},
+    {"next",                   next,                   IPC_NO_ARG,      false},
+    {"prev",                   prev,                   IPC_NO_ARG,      false},
+    {"choose",                 choose,                 IPC_NO_ARG,      true},
+    {"rise_main_n",            rise_main_n,            IPC_NO_ARG,      false},
+    {"fall_main_n",            fall_main_n,            IPC_NO_ARG,      false},
+    {"show_desktop",           show_desktop,           IPC_NO_ARG,      false},
+    {"toggle_focus_mode",      toggle_focus_mode,      IPC_NO_ARG,      false},
+    {"start",                  start,                  IPC_NO_ARG,      false},
+    {"open_client_menu",       open_client_menu,       IPC_NO_ARG,      true},
+    {"focus_desktop",          focus_desktop,          IPC_DESKTOP_ARG, false},
+    {"next_desktop",           next_desktop,           IPC_NO_ARG,      false},
+    {"prev_desktop",           prev_desktop,           IPC_NO_ARG,      false},
+    {"move_to_desktop",        move_to_desktop,        IPC_DESKTOP_ARG, true},
+    {"all_move_to_desktop",    all_move_to_desktop,    IPC_DESKTOP_ARG, false},
+    {"change_to_desktop",      change_to_desktop,      IPC_DESKTOP_ARG, true},
+    {"all_change_to_desktop",  all_change_to_desktop,  IPC_DESKTOP_ARG, false},
+    {"attach_to_desktop",      attach_to_desktop,      IPC_DESKTOP_ARG, true},
+    {"attach_to_all_desktops", attach_to_all_desktops, IPC_NO_ARG,      true},
+    {"all_attach_to_desktop",  all_attach_to_desktop,  IPC_DESKTOP_ARG, false},
+    {"run_cmd",                run_cmd,                IPC_NO_ARG,      false},
+    {"set_color",              set_color,              IPC_NO_ARG,      false},
+    {"switch_wallpaper",       switch_wallpaper,       IPC_NO_ARG,      false},
+    {"print_screen",           print_screen,           IPC_NO_ARG,      false},
+    {"print_win",              print_win,              IPC_NO_ARG,      true},
+    {"toggle_compositor",      toggle_compositor,      IPC_NO_ARG,      false},
+    {"mini",                   mini,                   IPC_NO_ARG,      true},
+    {"deiconify",              deiconify,              IPC_NO_ARG,      true},
+    {"scroll_iconbar",         scroll_iconbar,         IPC_N_ARG,       false},
+    {"toggle_max_restore",     toggle_max_restore,     IPC_NO_ARG,      true},
+    {"vmax",                   vmax,                   IPC_NO_ARG,      true},
+    {"hmax",                   hmax,                   IPC_NO_ARG,      true},
+    {"tmax",                   tmax,                   IPC_NO_ARG,      true},
+    {"bmax",                   bmax,                   IPC_NO_ARG,      true},
+    {"lmax",                   lmax,                   IPC_NO_ARG,      true},
+    {"rmax",                   rmax,                   IPC_NO_ARG,      true},
+    {"max",                    max,                    IPC_NO_ARG,      true},
+    {"toggle_shade",           toggle_shade,           IPC_NO_ARG,      true},
+    {"to_main_area",           to_main_area,           IPC_NO_ARG,      true},
+    {"to_second_area",         to_second_area,         IPC_NO_ARG,      true},
+    {"to_fixed_area",          to_fixed_area,          IPC_NO_ARG,      true},
+    {"to_above_layer",         to_above_layer,         IPC_NO_ARG,      true},
+    {"fullscreen",             fullscreen,             IPC_NO_ARG,      true},
+    {"to_below_layer",         to_below_layer,         IPC_NO_ARG,      true},
+    {"stack",                  stack,                  IPC_NO_ARG,      false},
+    {"tile",                   tile,                   IPC_NO_ARG,      false},
+    {"rise_main_area",         rise_main_area,         IPC_NO_ARG,      false},
+    {"fall_main_area",         fall_main_area,         IPC_NO_ARG,      false},
+    {"rise_fixed_area",        rise_fixed_area,        IPC_NO_ARG,      false},
+    {"fall_fixed_area",        fall_fixed_area,        IPC_NO_ARG,      false},
+};
+
+static const Ipc_query queries[]=
+{
+    {"get_clients", query_clients},
+    {"get_client",  query_client},
+    {"get_focus",   query_focus},
+    {"get_desktop", query_desktop},
+    {"get_layout",  query_layout},
+    {"get_evstats", query_evstats},
+    {"get_xres",    query_xres},
+    {"get_trace",   query_trace},
+    {"focus",       cmd_focus},
+    {"color",       cmd_color},
+};
+
+static int listen_fd=-1;
+static char *socket_path=NULL;
+static Ipc_client *ipc_clients[IPC_CLIENT_MAX];
+static size_t nipc_clients=0;
+
+void init_ipc(void)
+{
+    if(!(socket_path=get_ipc_socket_path()))
+        return;
+    if((listen_fd=open_ipc_socket(socket_path)) < 0)
+    {
+        perror(_("不能創建IPC套接字"));
+        Free(socket_path);
+        return;
+    }
+    setenv("GWM_SOCKET", socket_path, 1); // 供自啓動腳本等子進程使用
+}
+
+void deinit_ipc(void)
+{
+    while(nipc_clients)
+        flush_ipc_client(ipc_clients[0]), del_ipc_client(0);
+    if(listen_fd >= 0)
+        close(listen_fd), listen_fd=-1, unlink(socket_path);
+    Free(socket_path);
+}
+
+/* cfg->ipc_socket爲空字符串時不開啓IPC；爲NULL時優先放在$XDG_RUNTIME_DIR，
+ * 否則放在/tmp，文件名含顯示名以區分同時運行的多個gwm */
+static char *get_ipc_socket_path(void)
+{
+    if(cfg->ipc_socket)
+        return cfg->ipc_socket[0] ? copy_string(cfg->ipc_socket) : NULL;
+
+    const char *dir=getenv("XDG_RUNTIME_DIR");
+    char name[64], *p;
+
+    snprintf(name, sizeof(name), "%s", DisplayString(xinfo.display));
+    for(p=name; *p; p++)
+        if(*p == '/')
+            *p='_';
+    if(dir && dir[0])
+        return copy_strings(dir, "/gwm", name, ".sock", NULL);
+
+    char uid[32];
+    snprintf(uid, sizeof(uid), "%ld", (long)getuid());
+    return copy_strings("/tmp/gwm-", uid, name, ".sock", NULL);
+}
+
+static int open_ipc_socket(const char *path)
+{
+    struct sockaddr_un addr={.sun_family=AF_UNIX};
+    if(strlen(path) >= sizeof(addr.sun_path))
+        return errno=ENAMETOOLONG, -1;
+    strcpy(addr.sun_path, path);
+
+    int fd=socket(AF_UNIX, SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC, 0);
+    if(fd < 0)
+        return -1;
+
+    unlink(path); // 上次異常退出時可能遺留套接字文件
+    mode_t mask=umask(0177); // 只允許本用戶連接
+    int r=bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    umask(mask);
+    if(r<0 || listen(fd, IPC_CLIENT_MAX)<0)
+        return close(fd), -1;
+    return fd;
+}
+
+size_t get_ipc_pollfd_count(void)
+{
+    return listen_fd<0 ? 0 : nipc_clients+1;
+}
+
+// fds應至少有get_ipc_pollfd_count()個元素
+void set_ipc_pollfds(struct pollfd *fds)
+{
+    if(listen_fd < 0)
+        return;
+
+    fds[0]=(struct pollfd){listen_fd, POLLIN, 0};
+    for(size_t i=0; i<nipc_clients; i++)
+    {
+        const Ipc_client *ic=ipc_clients[i];
+        fds[i+1]=(struct pollfd){ic->fd, POLLIN|(ic->out_len ? POLLOUT : 0), 0};
+    }
+}
+
+/* fds應爲poll返回後的set_ipc_pollfds所設置的n個元素。全部命令執行完後纔處
+ * 理期間產生的布局更新請求 */
+void handle_ipc_events(const struct pollfd *fds, size_t n)
+{
+    for(size_t i=1; i<n; i++)
+    {
+        if(!fds[i].revents)
+            continue;
+        for(size_t j=0; j<nipc_clients; j++)
+        {
+            Ipc_client *ic=ipc_clients[j];
+            if(ic->fd == fds[i].fd)
+            {
+                bool ok=true;
+                if(fds[i].revents & (POLLIN|POLLHUP|POLLERR))
+                    ok=read_ipc_client(ic);
+                if(!flush_ipc_client(ic) || !ok)
+                    del_ipc_client(j);
+                break;
+            }
+        }
+    }
+    if(n && fds[0].revents&POLLIN)
+        accept_ipc_clients();
+    handle_layout_update_request();
+}
+
+static void accept_ipc_clients(void)
+{
+    for(int fd; (fd=accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK|SOCK_CLOEXEC)) >= 0; )
+        if(!add_ipc_client(fd))
+            close(fd);
+}
+
+static bool add_ipc_client(int fd)
+{
+    if(nipc_clients == IPC_CLIENT_MAX)
+        return false;
+
+    Ipc_client *ic=Malloc(sizeof(Ipc_client));
+    memset(ic, 0, sizeof(Ipc_client));
+    ic->fd=fd;
+    ipc_clients[nipc_clients++]=ic;
+    return true;
+}
+
+static void del_ipc_client(size_t i)
+{
+    Ipc_client *ic=ipc_clients[i];
+
+    close(ic->fd);
+    clear_ipc_batch(ic);
+    free(ic->out);
+    free(ic);
+    ipc_clients[i]=ipc_clients[--nipc_clients];
+}
+
+/* 讀取並執行已收到的完整命令行，返回false表示應斷開該客戶 */
+static bool read_ipc_client(Ipc_client *ic)
+{
+    ssize_t n=recv(ic->fd, ic->in+ic->in_len, sizeof(ic->in)-ic->in_len, 0);
+    if(n < 0)
+        return errno==EAGAIN || errno==EINTR;
+    if(n == 0)
+        return false;
+    ic->in_len += n;
+
+    char *buf=NULL, *begin=ic->in, *end;
+    size_t size=0;
+    FILE *fp=open_memstream(&buf, &size);
+    if(!fp)
+        return false;
+
+    while((end=memchr(begin, '\n', ic->in+ic->in_len-begin)))
+        *end='\0', handle_ipc_line(ic, fp, begin), begin=end+1;
+    ic->in_len -= begin-ic->in;
+    memmove(ic->in, begin, ic->in_len);
+
+    bool ok = ic->in_len < sizeof(ic->in);
+    if(!ok)
+        fputs("error: line too long\n", fp);
+    fclose(fp);
+    ok = append_ipc_output(ic, buf, size) && ok;
+    free(buf);
+    return ok;
+}
+
+static void handle_ipc_line(Ipc_client *ic, FILE *fp, char *line)
+{
+    size_t len=strlen(line);
+    if(len && line[len-1]=='\r')
+        line[len-1]='\0';
+    if(!line[0])
+        return;
+
+    if(strcmp(line, "begin") == 0)
+    {
+        if(ic->in_batch)
+            fputs("error: already in batch\n", fp);
+        else
+            ic->in_batch=true, fputs("ok\n", fp);
+    }
+    else if(strcmp(line, "commit") == 0)
+        commit_ipc_batch(ic, fp);
+    else if(!ic->in_batch)
+        run_ipc_cmd(fp, line);
+    else if(ic->batch_n == IPC_BATCH_MAX)
+        clear_ipc_batch(ic), fputs("error: batch too large\n", fp);
+    else
+        ic->batch[ic->batch_n++]=copy_string(line);
+}
+
+/* 依次答復暫存的各命令，最後答復commit本身 */
+static void commit_ipc_batch(Ipc_client *ic, FILE *fp)
+{
+    if(!ic->in_batch)
+    {
+        fputs("error: not in batch\n", fp);
+        return;
+    }
+    for(size_t i=0; i<ic->batch_n; i++)
+        run_ipc_cmd(fp, ic->batch[i]);
+    clear_ipc_batch(ic);
+    fputs("ok\n", fp);
+}
+
+static void clear_ipc_batch(Ipc_client *ic)
+{
+    for(size_t i=0; i<ic->batch_n; i++)
+        free(ic->batch[i]);
+    ic->batch_n=0, ic->in_batch=false;
+}
+
+static void run_ipc_cmd(FILE *fp, char *line)
+{
+    char *arg=NULL, *name=split_ipc_cmd(line, &arg);
+    const char *err="unknown command";
+
+    for(size_t i=0; i<ARRAY_NUM(actions); i++)
+        if(strcmp(name, actions[i].name) == 0)
+            err=run_ipc_action(actions+i, arg);
+    for(size_t i=0; i<ARRAY_NUM(queries); i++)
+        if(strcmp(name, queries[i].name) == 0)
+            err=queries[i].func(fp, arg);
+
+    if(err)
+        fprintf(fp, "error: %s\n", err);
+    else
+        fputs("ok\n", fp);
+}
+
+/* 就地把命令行分割爲命令名和參數，無參數時*arg爲NULL */
+static char *split_ipc_cmd(char *line, char **arg)
+{
+    char *p=line+strspn(line, " \t"), *name=p;
+
+    p += strcspn(p, " \t");
+    if(*p)
+        *p++='\0', p+=strspn(p, " \t");
+    *arg = *p ? p : NULL;
+    return name;
+}
+
+static const char *run_ipc_action(const Ipc_action *a, const char *arg)
+{
+    XEvent e={.type=KeyPress}; // 使get_desktop_n等函數採用參數中的值
+    Arg farg={0};
+
+    if(a->need_client && !get_cur_focus_client())
+        return "no focused client";
+    switch(a->arg_type)
+    {
+        case IPC_NO_ARG:
+            break;
+        case IPC_DESKTOP_ARG:
+            if(!arg || !parse_desktop_n(arg, &farg.desktop_n))
+                return "invalid desktop";
+            break;
+        case IPC_N_ARG:
+            farg.n = arg ? atoi(arg) : 0;
+            break;
+        case IPC_CMD_ARG:
+            if(!arg)
+                return "missing command";
+            a->func(&e, (Arg){.cmd=SH_CMD(arg)});
+            return NULL;
+    }
+    a->func(&e, farg);
+    return NULL;
+}
+
+/* 虛擬桌面從0開始編號，all表示所有虛擬桌面 */
+static bool parse_desktop_n(const char *arg, unsigned int *n)
+{
+    char *end;
+    if(strcmp(arg, "all") == 0)
+        return *n=~0U, true;
+    *n=strtoul(arg, &end, 10);
+    return end!=arg && !*end && *n<DESKTOP_N;
+}
+
+static bool parse_win(const char *arg, Window *win)
+{
+    char *end;
+    if(!arg)
+        return false;
+    *win=strtoul(arg, &end, 0);
+    return end!=arg && !*end;
+}
+
+/* 每行依次爲：窗口、虛擬桌面掩碼、橫坐標、縱坐標、寬、高、層、區、是否縮微、
+ * 程序類型名、標題 */
+static const char *query_clients(FILE *fp, const char *arg)
+{
+    UNUSED(arg);
+    clients_for_each(c)
+        print_client_info(fp, c);
+    return NULL;
+}
+
+static const char *query_client(FILE *fp, const char *arg)
+{
+    Window win;
+    Client *c=NULL;
+
+    if(!parse_win(arg, &win) || !(c=win_to_client(win)))
+        return "no such client";
+    print_client_info(fp, c);
+    return NULL;
+}
+
+static void print_client_info(FILE *fp, const Client *c)
+{
+    static const char *layers[]={"fullscreen", "dock", "above", "float",
+        "normal", "below", "desktop"}, *areas[]={"main", "second", "fixed"};
+    const char *title=c->title_text ? c->title_text : "";
+
+    fprintf(fp, "0x%lx 0x%x %d %d %d %d %s %s %d %s ", WIDGET_WIN(c),
+        c->desktop_mask, WIDGET_X(c), WIDGET_Y(c), WIDGET_W(c), WIDGET_H(c),
+        layers[c->layer], areas[c->area], is_iconic_client(c),
+        c->class_name ? c->class_name : "-");
+    for(const char *p=title; *p; p++) // 標題中的換行符會破壞按行劃分的答復
+        fputc(*p=='\n' ? ' ' : *p, fp);
+    fputc('\n', fp);
+}
+
+static const char *query_focus(FILE *fp, const char *arg)
+{
+    UNUSED(arg);
+    Client *c=get_cur_focus_client();
+    fprintf(fp, "0x%lx\n", c ? WIDGET_WIN(c) : None);
+    return NULL;
+}
+
+static const char *query_desktop(FILE *fp, const char *arg)
+{
+    UNUSED(arg);
+    fprintf(fp, "%u %d\n", get_net_current_desktop(), DESKTOP_N);
+    return NULL;
+}
+
+static const char *query_layout(FILE *fp, const char *arg)
+{
+    UNUSED(arg);
+    fprintf(fp, "%s\n", is_spec_layout(TILE) ? "tile" : "stack");
+    return NULL;
+}
+
+static const char *query_evstats(FILE *fp, const char *arg)
+{
+    UNUSED(arg);
+    if(!event_stats_enabled)
+        return "event stats disabled";
+    dump_event_stats(fp);
+    return NULL;
+}
+
+static const char *query_xres(FILE *fp, const char *arg)
+{
+    UNUSED(arg);
+    dump_xres(fp);
+    return NULL;
+}
+
+static const char *query_trace(FILE *fp, const char *arg)
+{
+    UNUSED(arg);
+    if(!trace_enabled)
+        return "trace disabled";
+    dump_trace(fp);
+    return NULL;
+}
+
+static const char *cmd_focus(FILE *fp, const char *arg)
+{
+    UNUSED(fp);
+    Window win;
+    Client *c=NULL;
+
+    if(!parse_win(arg, &win) || !(c=win_to_client(win)))
+        return "no such client";
+    if(!is_on_cur_desktop(c))
+        return "client not on current desktop";
+    if(is_iconic_client(c))
+        deiconify_client(c);
+    else
+        focus_client(c);
+    return NULL;
+}
+
+static const char *cmd_color(FILE *fp, const char *arg)
+{
+    UNUSED(fp);
+    if(!arg)
+        return "missing color name";
+    set_main_color_name(arg);
+    update_gui();
+    return NULL;
+}
+
+/* 返回false表示答復積壓過多，應斷開該客戶 */
+static bool append_ipc_output(Ipc_client *ic, const char *s, size_t n)
+{
+    if(ic->out_len+n > IPC_OUT_MAX)
+        return false;
+    if(ic->out_len+n > ic->out_size)
+    {
+        size_t size=MAX(2*ic->out_size, ic->out_len+n);
+        char *p=realloc(ic->out, size);
+        if(p == NULL)
+            exit_with_msg(_("錯誤：申請內存失敗"));
+        ic->out=p, ic->out_size=size;
+    }
+    memcpy(ic->out+ic->out_len, s, n);
+    ic->out_len += n;
+    return true;
+}
+
+/* 盡量發送答復，未發完的部分待套接字可寫時再發。返回false表示應斷開該客戶 */
+static bool flush_ipc_client(Ipc_client *ic)
+{
+    size_t i=0;
+    while(i < ic->out_len)
+    {
+        ssize_t n=send(ic->fd, ic->out+i, ic->out_len-i, MSG_NOSIGNAL);
+        if(n > 0)
+            i += n;
+        else if(n<0 && errno==EINTR)
+            continue;
+        else if(n<0 && errno==EAGAIN)
+            break;
+        else
+            return false;
+    }
+    ic->out_len -= i;
+    memmove(ic->out, ic->out+i, ic->out_len);
+    return true;
+}
@@ -12,6 +12,8 @@
 #include "misc.h"
 #include "config.h"
 #include "clientop.h"
+#include "trace.h"
+#include "fullscreen.h"
 #include "layout.h"
 #include "prop.h"
 #include "icccm.h"
@@ -46,15 +48,36 @@ static void set_main_area_ratio(double ratio);
 static double get_fixed_area_ratio(void);
 static void set_fixed_area_ratio(double ratio);
 
+static bool layout_update_requested=false; // 是否有待處理的布局更新請求
+
 static int main_area_ns[DESKTOP_N]; // 主區域可容納的客戶窗口數量
 static Layout layouts[DESKTOP_N]; // 爲當前布局模式
 static double main_area_ratios[DESKTOP_N], fixed_area_ratios[DESKTOP_N]; // 分別爲主要和固定區域與工作區寬度的比值
 
+/* 布局更新請求只設置標志，待當前事件或當前批IPC命令處理完後由
+ * handle_layout_update_request統一更新一次，以免連續的操作逐一重新布局 */
+void request_layout_update(void)
+{
+    layout_update_requested=true;
+}
+
+void handle_layout_update_request(void)
+{
+    if(!layout_update_requested)
+        return;
+    layout_update_requested=false;
+    update_layout();
+}
+
 void update_layout(void)
 {
     if(clients_is_empty())
+    {
+        update_fullscreen_mode();
         return;
+    }
 
+    TRACE_BEGIN("update_layout", None);
     switch(get_layout())
     {
         case STACK: set_stack_layout(); break;
@@ -63,6 +86,8 @@ void update_layout(void)
     clients_for_each(c)
         if(is_on_cur_desktop(c))
             move_resize_client(c, NULL);
+    update_fullscreen_mode();
+    TRACE_END("update_layout", None);
 }
 
 static void set_stack_layout(void)
@@ -323,7 +348,7 @@ void pointer_adjust_layout_ratio(XEvent *e)
         {
             nx=ev.xmotion.x, dx=nx-ox;
             if(abs(dx)>=cfg->resize_inc && change_layout_ratio(ox, nx))
-                request_layout_update(), ox=nx;
+                update_layout(), ox=nx;
         }
         else
             handle_event(&ev);
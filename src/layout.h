@@ -15,6 +15,8 @@
 #include "gwm.h"
 #include "widget.h"
 
+void request_layout_update(void);
+void handle_layout_update_request(void);
 void update_layout(void);
 bool is_main_sec_gap(int x);
 bool is_main_fix_gap(int x);
@@ -13,17 +13,41 @@
 #include "gwm.h"
 #include "listview.h"
 
+/* 清單顯示構件持有條目的副本，並記住每個顯示行當前所繪製的內容。更新時只重繪
+ * 內容或選中狀態有變化的行，窗口採用西北位重力以便縮放時保留未變的行。窗口
+ * 的內容在隱藏後會丟失，而隱藏可能來自外部，故在顯示未映射的窗口時清空已繪製
+ * 內容的記錄，迫使其後全部重繪 */
+typedef struct // 顯示行的已繪製內容
+{
+    char *text; // 所顯示的文字，NULL表示尚未繪製
+    bool chosen; // 是否顯示爲選中狀態
+} Listview_line;
+
 struct _listview_tag // 清單顯示構件
 {
     Widget base;
-    const Strings *texts;
-    int nmax;
+    char **rows; // 條目的副本
+    int n, nmax; // 條目數、可顯示的最大條目數
+    int top, chosen; // 首個可見條目的索引、選中條目的索引
+    Listview_line *lines; // 各顯示行的已繪製內容
+    int nlines; // lines的元素數
 };
 
 static void listview_ctor(Listview *listview, Widget *parent, Widget_id id, int x, int y, int w, int h, const Strings *texts);
 static int get_strings_width(const Strings *texts);
 static int get_strings_height(const Strings *texts);
 static void listview_set_method(Widget *widget);
+static void listview_dtor(Listview *listview);
+static void listview_set_rows(Listview *listview, const Strings *texts);
+static void free_rows(Listview *listview);
+static void clear_lines(Listview *listview);
+static int get_visible_n(const Listview *listview);
+static int get_real_visible_n(const Listview *listview);
+static const char *get_line_text(const Listview *listview, int i);
+static void listview_draw_lines(Listview *listview, bool force);
+static void listview_draw_line(Listview *listview, int i, const char *text, bool chosen);
+static void reserve_lines(Listview *listview, int n);
+static void listview_scroll_to_chosen(Listview *listview);
 
 Listview *listview_new(Widget *parent, Widget_id id, int x, int y, int w, int h, const Strings *texts)
 {
@@ -38,12 +62,19 @@ Listview *listview_new(Widget *parent, Widget_id id, int x, int y, int w, int h,
 
 static void listview_ctor(Listview *listview, Widget *parent, Widget_id id, int x, int y, int w, int h, const Strings *texts)
 {
+    XSetWindowAttributes attr={.bit_gravity=NorthWestGravity};
+
     w = w>0 ? w : get_strings_width(texts);
     h = h>0 ? h : get_strings_height(texts);
     widget_ctor(WIDGET(listview), parent, WIDGET_TYPE_LISTVIEW, id, x, y, w, h);
     XSelectInput(xinfo.display, WIDGET_WIN(listview), None);
-    listview->texts=texts;
+    XChangeWindowAttributes(xinfo.display, WIDGET_WIN(listview), CWBitGravity, &attr);
+    listview->rows=NULL;
+    listview->n=listview->top=listview->chosen=0;
     listview->nmax=INT_MAX;
+    listview->lines=NULL;
+    listview->nlines=0;
+    listview_set_rows(listview, texts);
     listview_set_method(WIDGET(listview));
 }
 
@@ -71,50 +102,183 @@ static int get_strings_height(const Strings *texts)
 
 static void listview_set_method(Widget *widget)
 {
+    widget->del=listview_del;
     widget->show=listview_show;
+    widget->hide=listview_hide;
     widget->update_fg=listview_update_fg;
 }
 
+void listview_del(Widget *widget)
+{
+    listview_dtor(LIST_VIEW(widget));
+    widget_del(widget);
+}
+
+static void listview_dtor(Listview *listview)
+{
+    free_rows(listview);
+    clear_lines(listview);
+    Free(listview->lines);
+}
+
+static void listview_set_rows(Listview *listview, const Strings *texts)
+{
+    int i=0, n = texts ? LIST_COUNT(texts) : 0;
+
+    free_rows(listview);
+    listview->rows = n ? Malloc(n*sizeof(char *)) : NULL;
+    if(texts)
+        LIST_FOR_EACH(Strings, s, texts)
+            listview->rows[i++]=copy_string(s->str);
+    listview->n=n;
+    listview->top=listview->chosen=0;
+}
+
+static void free_rows(Listview *listview)
+{
+    for(int i=0; i<listview->n; i++)
+        Free(listview->rows[i]);
+    Free(listview->rows);
+    listview->rows=NULL;
+    listview->n=0;
+}
+
+static void clear_lines(Listview *listview)
+{
+    for(int i=0; i<listview->nlines; i++)
+        Free(listview->lines[i].text), listview->lines[i].text=NULL;
+}
+
 void listview_show(Widget *widget)
 {
+    if(!widget_is_viewable(widget))
+        clear_lines(LIST_VIEW(widget));
     XRaiseWindow(xinfo.display, WIDGET_WIN(widget));
     widget_show(widget);
 }
 
+void listview_hide(const Widget *widget)
+{
+    widget_hide(widget);
+}
+
 void listview_update_fg(const Widget *widget)
 {
-    Listview *listview=LIST_VIEW(widget);
-    if(!listview->texts)
-        return;
-    
-    Window win=WIDGET_WIN(listview);
-    int w=WIDGET_W(listview), h=get_font_height_by_pad(),
-        i=0, nmax=listview->nmax;
-    Str_fmt fmt={0, 0, w, h, CENTER_LEFT, true, false, 0,
-        get_text_color(widget)};
-
-    LIST_FOR_EACH(Strings, s, listview->texts)
+    listview_draw_lines(LIST_VIEW(widget), true);
+}
+
+static int get_visible_n(const Listview *listview)
+{
+    return MIN(listview->n, listview->nmax);
+}
+
+/* 可見條目之後還有條目時，最後一個顯示行顯示爲省略號 */
+static int get_real_visible_n(const Listview *listview)
+{
+    int nv=get_visible_n(listview);
+    return nv>1 && listview->top+nv<listview->n ? nv-1 : nv;
+}
+
+static const char *get_line_text(const Listview *listview, int i)
+{
+    return i<get_real_visible_n(listview) ? listview->rows[listview->top+i] : "...";
+}
+
+static void listview_draw_lines(Listview *listview, bool force)
+{
+    int nv=get_visible_n(listview);
+
+    reserve_lines(listview, nv);
+    for(int i=0; i<nv; i++)
     {
-        if(i < nmax)
-            draw_string(win, i<nmax-1 ? s->str : "...", &fmt), fmt.y+=h;
-        else
-            break;
-        i++;
+        const char *text=get_line_text(listview, i);
+        bool chosen = listview->top+i == listview->chosen;
+        Listview_line *line=listview->lines+i;
+
+        if( force || !line->text || line->chosen!=chosen
+            || strcmp(line->text, text))
+            listview_draw_line(listview, i, text, chosen);
     }
+    // 超出可見範圍的行已隨窗口縮小而消失，須忘記其內容
+    for(int i=nv; i<listview->nlines; i++)
+        Free(listview->lines[i].text), listview->lines[i].text=NULL;
+}
+
+static void listview_draw_line(Listview *listview, int i, const char *text, bool chosen)
+{
+    Listview_line *line=listview->lines+i;
+    int w=WIDGET_W(listview), h=get_font_height_by_pad();
+    Color_id cid = chosen ? COLOR_CHOSEN : COLOR_NORMAL;
+    Str_fmt fmt={0, i*h, w, h, CENTER_LEFT, true, chosen,
+        find_widget_color(cid), chosen ? find_text_color(cid)
+        : get_text_color(WIDGET(listview))};
+
+    draw_string(WIDGET_WIN(listview), text, &fmt);
+    if(!line->text || strcmp(line->text, text))
+        Free(line->text), line->text=copy_string(text);
+    line->chosen=chosen;
+}
+
+static void reserve_lines(Listview *listview, int n)
+{
+    if(n <= listview->nlines)
+        return;
+
+    Listview_line *lines=Malloc(n*sizeof(Listview_line));
+    for(int i=0; i<n; i++)
+        lines[i] = i<listview->nlines ? listview->lines[i] : (Listview_line){0};
+    Free(listview->lines);
+    listview->lines=lines;
+    listview->nlines=n;
 }
 
+/* 以texts的副本替換原有條目，只重繪有變化的行 */
 void listview_update(Listview *listview, const Strings *texts)
 {
-    int w=WIDGET_W(listview), hl=get_font_height_by_pad(),
-        n=LIST_COUNT(texts), h=MIN(n, listview->nmax)*hl;
+    listview_set_rows(listview, texts);
+    if(!listview->n)
+    {
+        listview_hide(WIDGET(listview));
+        return;
+    }
 
-    listview->texts=texts;
-    widget_resize(WIDGET(listview), w, h);
+    int w=WIDGET_W(listview), h=get_visible_n(listview)*get_font_height_by_pad();
+    if(h != WIDGET_H(listview))
+        widget_resize(WIDGET(listview), w, h);
     listview_show(WIDGET(listview));
-    listview_update_fg(WIDGET(listview));
+    listview_draw_lines(listview, false);
 }
 
 void listview_set_nmax(Listview *listview, int nmax)
 {
     listview->nmax=nmax;
 }
+
+/* 在已有條目中移動選中條目並按需滾動，不必重新查詢條目 */
+void listview_move_chosen(Listview *listview, int delta)
+{
+    if(!listview->n)
+        return;
+
+    listview->chosen=MAX(0, MIN(listview->chosen+delta, listview->n-1));
+    listview_scroll_to_chosen(listview);
+    listview_draw_lines(listview, false);
+}
+
+static void listview_scroll_to_chosen(Listview *listview)
+{
+    if(listview->chosen < listview->top)
+        listview->top=listview->chosen;
+    while(listview->chosen >= listview->top+get_real_visible_n(listview))
+        listview->top++;
+}
+
+const char *listview_get_chosen(const Listview *listview)
+{
+    return listview->n ? listview->rows[listview->chosen] : NULL;
+}
+
+int listview_get_visible_n(const Listview *listview)
+{
+    return get_visible_n(listview);
+}
@@ -20,9 +20,14 @@ typedef struct _listview_tag Listview;
 #define LIST_VIEW(widget) ((Listview *)(widget))
 
 Listview *listview_new(Widget *parent, Widget_id id, int x, int y, int w, int h, const Strings *texts);
+void listview_del(Widget *widget);
 void listview_show(Widget *widget);
+void listview_hide(const Widget *widget);
 void listview_update_fg(const Widget *widget);
 void listview_update(Listview *listview, const Strings *texts);
 void listview_set_nmax(Listview *listview, int nmax);
+void listview_move_chosen(Listview *listview, int delta);
+const char *listview_get_chosen(const Listview *listview);
+int listview_get_visible_n(const Listview *listview);
 
 #endif
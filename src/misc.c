@@ -9,10 +9,13 @@
  * <http://www.gnu.org/licenses/>。
  * ************************************************************************/
 
+#define _POSIX_C_SOURCE 200809L // 爲了使用clock_gettime
+
 #include <stdio.h>
 #include <string.h>
 #include <stdarg.h>
 #include <signal.h>
+#include <time.h>
 #include <X11/Xproto.h>
 #include <X11/Xutil.h>
 #include "misc.h"
@@ -66,6 +69,15 @@ char *copy_string(const char *s)
     return s ? strcpy(Malloc(strlen(s)+1), s) : NULL;
 }
 
+/* 計算字符串的FNV-1a散列值 */
+uint64_t get_string_hash(const char *s)
+{
+    uint64_t hash=14695981039346656037ULL;
+    for(const unsigned char *p=(const unsigned char *)s; *p; p++)
+        hash=(hash^*p)*1099511628211ULL;
+    return hash;
+}
+
 char *copy_strings(const char *s, ...) // 調用時須以NULL結尾
 {
     if(!s)
@@ -116,6 +128,14 @@ unsigned int get_desktop_mask(unsigned int desktop_n)
     return desktop_n==~0U ? desktop_n : 1U<<desktop_n;
 }
 
+/* 返回單調時鐘的當前微秒數，只宜用於計算時間間隔 */
+uint64_t get_monotonic_us(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec*1000000+t.tv_nsec/1000;
+}
+
 bool should_quit(void)
 {
     return quit_flag==true;
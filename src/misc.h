@@ -13,6 +13,7 @@
 #define MISC_H
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <libintl.h>
 #include <X11/Xlib.h>
 #include "gwm.h"
@@ -61,11 +62,13 @@ void exit_with_perror(const char *s);
 void exit_with_msg(const char *msg);
 char *copy_string(const char *s);
 char *copy_strings(const char *s, ...);
+uint64_t get_string_hash(const char *s);
 void vfree_strings(Strings *head);
 int base_n_floor(int x, int n);
 int base_n_ceil(int x, int n);
 bool is_match_button_release(XButtonEvent *oe, XButtonEvent *ne);
 unsigned int get_desktop_mask(unsigned int desktop_n);
+uint64_t get_monotonic_us(void);
 bool should_quit(void);
 void request_quit(void);
 void init_event_handler(Event_handler handler);
@@ -15,71 +15,120 @@
 #include "sizehintwin.h"
 #include "focus.h"
 #include "grab.h"
+#include "syncreq.h"
+#include "xres.h"
 #include "mvresize.h"
 
+/* 按住按鍵時，自動重復產生的按鍵事件使步長逐漸增大 */
+#define KEY_ACCEL_STEP_N 8 // 每自動重復多少次步長增加一個單位
+#define KEY_ACCEL_MAX 8 // 步長最多爲多少個單位
+
 typedef struct /* 定位器所點擊的窗口位置每次合理移動或調整尺寸所對應的舊、新坐標信息 */
 {
     int ox, oy, nx, ny; /* 分別爲舊、新坐標 */
 } Move_info;
 
-static bool fix_first_move_resize(Client *c, Delta_rect *d);
-static void wait_key_release(XEvent *e);
-static Delta_rect get_key_delta_rect(Client *c, Key_act act);
-static void do_valid_pointer_move_resize(Client *c, Move_info *m, Pointer_act act, bool is_to_float);
+static bool fix_first_move_resize(Client *c, const XSizeHints *hint, Delta_rect *d);
+static void key_move_resize_loop(XEvent *e, Client *c, const XSizeHints *hint, Key_act op, bool is_move);
+static bool is_same_key(const XEvent *e, const XEvent *ev);
+static bool is_key_repeat(const XEvent *ev);
+static void sync_move_resize_client(Client *c, const Delta_rect *d);
+static Delta_rect get_key_delta_rect(const XSizeHints *hint, Key_act act, int n);
+static void pointer_move_resize_loop(XEvent *e, Client *c, const XSizeHints *hint, Move_info *m, Pointer_act act, bool outline);
+static void do_valid_pointer_move_resize(Client *c, const XSizeHints *hint, Move_info *m, Pointer_act act, bool is_to_float, bool outline);
+static GC create_outline_gc(Client *c);
+static void draw_outline(Client *c, GC gc);
 static Delta_rect get_pointer_delta_rect(const Move_info *m, Pointer_act act);
-static bool get_move_resize_delta_rect(Client *c, Delta_rect *d, bool is_move, bool is_to_float);
+static bool get_move_resize_delta_rect(Client *c, const XSizeHints *hint, Delta_rect *d, bool is_move, bool is_to_float);
 static bool is_prefer_move(Client *c, Delta_rect *d);
-static bool fix_delta_rect(Client *c, Delta_rect *d);
-static void fix_dw_by_width_hint(int w, XSizeHints *hint, int *dw);
-static void fix_dh_by_height_hint(int h, XSizeHints *hint, int *dh);
+static bool fix_delta_rect(Client *c, const XSizeHints *hint, Delta_rect *d);
+static void fix_dw_by_width_hint(int w, const XSizeHints *hint, int *dw);
+static void fix_dh_by_height_hint(int h, const XSizeHints *hint, int *dh);
 
+/* 尺寸特性在每次操作開始時只讀取一次，並在整個操作過程中使用 */
 void key_move_resize_client(XEvent *e, Key_act op)
 {
     Client *c=get_cur_focus_client();
     bool is_move = (op==UP || op==DOWN || op==LEFT || op==RIGHT),
          is_to_float=(c->area==MAIN_AREA || c->area==SECOND_AREA || c->area==FIXED_AREA);
-    Delta_rect d=get_key_delta_rect(c, op);
+    XSizeHints hint=get_size_hint(WIDGET_WIN(c));
+    Delta_rect d=get_key_delta_rect(&hint, op, 1);
 
     if(is_to_float)
         move_client(c, NULL, FLOAT_LAYER, ANY_AREA);
-    if(get_move_resize_delta_rect(c, &d, is_move, is_to_float))
-    {
-        move_resize_client(c, &d);
-        Size_hint_win *shw=size_hint_win_new(WIDGET(c));
-        widget_show(WIDGET(shw));
-        wait_key_release(e);
-        widget_del(WIDGET(shw));
-    }
+    if(get_move_resize_delta_rect(c, &hint, &d, is_move, is_to_float))
+        sync_move_resize_client(c, &d);
+    size_hint_win_begin(WIDGET(c), &hint);
+    key_move_resize_loop(e, c, &hint, op, is_move);
+    size_hint_win_end();
+}
+
+/* 調整尺寸時，按_NET_WM_SYNC_REQUEST協議等待客戶重繪完成後纔返回，從而使下一次
+ * 配置請求不會早於客戶的重繪。單純移動窗口不會令客戶重繪，故不必同步。 */
+static void sync_move_resize_client(Client *c, const Delta_rect *d)
+{
+    bool sync=(d->dw || d->dh) && request_client_sync(c);
+
+    move_resize_client(c, d);
+    if(sync)
+        wait_client_sync(c);
 }
 
-static bool fix_first_move_resize(Client *c, Delta_rect *d)
+static bool fix_first_move_resize(Client *c, const XSizeHints *hint, Delta_rect *d)
 {
     int ow=WIDGET_W(c), oh=WIDGET_H(c), nw=ow, nh=oh;
-    XSizeHints hint=get_size_hint(WIDGET_WIN(c));
-    fix_win_size_by_hint(&hint, &nw, &nh);
+    fix_win_size_by_hint(hint, &nw, &nh);
     d->dw=nw-ow;
     d->dh=nh-oh;
     return d->dw || d->dh;
 }
 
-static void wait_key_release(XEvent *e)
+/* 在鬆開按鍵前，按鍵的自動重復會產生成對的KeyRelease和KeyPress事件，此時在
+ * 本循環中直接處理KeyPress，而不必每次都重新開始一次操作 */
+static void key_move_resize_loop(XEvent *e, Client *c, const XSizeHints *hint, Key_act op, bool is_move)
 {
-    while(1)
+    XEvent ev;
+
+    for(int repeat_n=0; ;)
     {
-        XEvent ev;
         XMaskEvent(xinfo.display, ROOT_EVENT_MASK|KeyReleaseMask, &ev);
-        if( ev.type==KeyRelease && ev.xkey.state==e->xkey.state
-            && ev.xkey.keycode==e->xkey.keycode)
-            break;
-        else
+        if(!is_same_key(e, &ev))
             handle_event(&ev);
+        else if(ev.type == KeyPress)
+        {
+            repeat_n++;
+            int n=MIN(1+repeat_n/KEY_ACCEL_STEP_N, KEY_ACCEL_MAX);
+            Delta_rect d=get_key_delta_rect(hint, op, n);
+            if(get_move_resize_delta_rect(c, hint, &d, is_move, false))
+                sync_move_resize_client(c, &d), size_hint_win_update();
+        }
+        else if(!is_key_repeat(&ev))
+            break;
     }
 }
 
-static Delta_rect get_key_delta_rect(Client *c, Key_act act)
+static bool is_same_key(const XEvent *e, const XEvent *ev)
 {
-    XSizeHints hint=get_size_hint(WIDGET_WIN(c));
-    int wi=hint.width_inc, hi=hint.height_inc;
+    return (ev->type==KeyPress || ev->type==KeyRelease)
+        && ev->xkey.state==e->xkey.state && ev->xkey.keycode==e->xkey.keycode;
+}
+
+/* 自動重復產生的KeyRelease與隨後的KeyPress時間戳相同且同時到達 */
+static bool is_key_repeat(const XEvent *ev)
+{
+    XEvent next;
+
+    if(!XEventsQueued(xinfo.display, QueuedAfterReading))
+        return false;
+    XPeekEvent(xinfo.display, &next);
+    return next.type==KeyPress && next.xkey.keycode==ev->xkey.keycode
+        && next.xkey.time==ev->xkey.time;
+}
+
+/* n爲步長的單位數 */
+static Delta_rect get_key_delta_rect(const XSizeHints *hint, Key_act act, int n)
+{
+    int wi=hint->width_inc*n, hi=hint->height_inc*n;
 
     Delta_rect dr[] =
     {
@@ -95,7 +144,10 @@ static Delta_rect get_key_delta_rect(Client *c, Key_act act)
     return dr[act];
 }
 
-void pointer_move_resize_client(XEvent *e, bool resize)
+/* 以輪廓方式移動和調整尺寸時，拖動過程中只更新客戶窗口的幾何信息並以異或方式
+ * 畫出框架輪廓，鬆開定位器按鈕後纔一次性地移動和調整窗口，從而避免重新布局代價
+ * 高昂的客戶在拖動過程中反復重繪。 */
+void pointer_move_resize_client(XEvent *e, bool resize, bool outline)
 {
     Move_info m={e->xbutton.x_root, e->xbutton.y_root, 0, 0};
     Client *c=get_cur_focus_client();
@@ -105,42 +157,66 @@ void pointer_move_resize_client(XEvent *e, bool resize)
         return;
 
     XSizeHints hint=get_size_hint(WIDGET_WIN(c));
+    if(act==MOVE || is_resizable(&hint))
+        pointer_move_resize_loop(e, c, &hint, &m, act, outline || c->outline_mvresize);
+    XUngrabPointer(xinfo.display, CurrentTime);
+}
 
+static void pointer_move_resize_loop(XEvent *e, Client *c, const XSizeHints *hint, Move_info *m, Pointer_act act, bool outline)
+{
+    bool is_to_float=(c->area==MAIN_AREA || c->area==SECOND_AREA || c->area==FIXED_AREA);
+    int ox=WIDGET_X(c), oy=WIDGET_Y(c), ow=WIDGET_W(c), oh=WIDGET_H(c);
+    GC gc=NULL;
     XEvent ev;
-    if(act==MOVE || is_resizable(&hint))
+
+    size_hint_win_begin(WIDGET(c), hint);
+    if(outline) // 獨占服務器，以免其他客戶的繪圖破壞異或輪廓
+        XGrabServer(xinfo.display), gc=create_outline_gc(c), draw_outline(c, gc);
+    do /* 因設置了獨享定位器且XMaskEvent會阻塞，故應處理按、放按鈕之間的事件 */
     {
-        bool is_to_float=(c->area==MAIN_AREA || c->area==SECOND_AREA || c->area==FIXED_AREA);
-        Size_hint_win *shw=size_hint_win_new(WIDGET(c));
-        widget_show(WIDGET(shw));
-        do /* 因設置了獨享定位器且XMaskEvent會阻塞，故應處理按、放按鈕之間的事件 */
+        XMaskEvent(xinfo.display, ROOT_EVENT_MASK|POINTER_MASK, &ev);
+        if(outline)
+            draw_outline(c, gc);
+        if(ev.type == MotionNotify)
         {
-            XMaskEvent(xinfo.display, ROOT_EVENT_MASK|POINTER_MASK, &ev);
-            if(ev.type == MotionNotify)
-            {
-                if(is_to_float)
-                    move_client(c, NULL, FLOAT_LAYER, ANY_AREA);
-                /* 因X事件是異步的，故xmotion.x和ev.xmotion.y可能不是連續變化 */
-                m.nx=ev.xmotion.x, m.ny=ev.xmotion.y;
-                do_valid_pointer_move_resize(c, &m, act, is_to_float);
-                if(is_to_float)
-                    is_to_float=false;
-                size_hint_win_update(shw);
-            }
-            else
-                handle_event(&ev);
-        }while(!is_match_button_release(&e->xbutton, &ev.xbutton));
-        widget_del(WIDGET(shw));
+            if(is_to_float)
+                move_client(c, NULL, FLOAT_LAYER, ANY_AREA);
+            // 等待客戶重繪期間積壓的移動事件只需處理最後一個
+            while(XCheckTypedEvent(xinfo.display, MotionNotify, &ev))
+                ;
+            /* 因X事件是異步的，故xmotion.x和ev.xmotion.y可能不是連續變化 */
+            m->nx=ev.xmotion.x, m->ny=ev.xmotion.y;
+            do_valid_pointer_move_resize(c, hint, m, act, is_to_float, outline);
+            if(is_to_float)
+                is_to_float=false;
+            size_hint_win_update();
+        }
+        else
+            handle_event(&ev);
+        if(outline && !is_match_button_release(&e->xbutton, &ev.xbutton))
+            draw_outline(c, gc);
+    }while(!is_match_button_release(&e->xbutton, &ev.xbutton));
+    size_hint_win_end();
+
+    if(outline)
+    {
+        free_gc(gc);
+        XUngrabServer(xinfo.display);
+        if(ox!=WIDGET_X(c) || oy!=WIDGET_Y(c) || ow!=WIDGET_W(c) || oh!=WIDGET_H(c))
+            move_resize_client(c, NULL);
     }
-    XUngrabPointer(xinfo.display, CurrentTime);
 }
 
-static void do_valid_pointer_move_resize(Client *c, Move_info *m, Pointer_act act, bool is_to_float)
+static void do_valid_pointer_move_resize(Client *c, const XSizeHints *hint, Move_info *m, Pointer_act act, bool is_to_float, bool outline)
 {
     Delta_rect d=get_pointer_delta_rect(m, act);
-    if(!get_move_resize_delta_rect(c, &d, act==MOVE, is_to_float))
+    if(!get_move_resize_delta_rect(c, hint, &d, act==MOVE, is_to_float))
         return;
 
-    move_resize_client(c, &d);
+    if(outline)
+        WIDGET_X(c)+=d.dx, WIDGET_Y(c)+=d.dy, WIDGET_W(c)+=d.dw, WIDGET_H(c)+=d.dh;
+    else
+        sync_move_resize_client(c, &d);
     if(act != MOVE)
     {
         if(d.dw) // dx爲0表示定位器從窗口右邊調整尺寸，非0則表示左邊調整
@@ -152,6 +228,28 @@ static void do_valid_pointer_move_resize(Client *c, Move_info *m, Pointer_act ac
         m->ox=m->nx, m->oy=m->ny;
 }
 
+static GC create_outline_gc(Client *c)
+{
+    XGCValues v;
+
+    v.function=GXinvert;
+    v.plane_mask=AllPlanes;
+    v.line_width=MAX(WIDGET_BORDER_W(c->frame), 1);
+    v.subwindow_mode=IncludeInferiors;
+    return create_gc(xinfo.root_win,
+        GCFunction|GCPlaneMask|GCLineWidth|GCSubwindowMode, &v, "mvresize");
+}
+
+/* 以異或方式畫出框架外沿，再畫一次即可擦除 */
+static void draw_outline(Client *c, GC gc)
+{
+    int bw=WIDGET_BORDER_W(c->frame), bh=frame_get_titlebar_height(c->frame),
+        lw=MAX(bw, 1), x=WIDGET_X(c)-bw, y=WIDGET_Y(c)-bh-bw,
+        w=WIDGET_W(c)+2*bw, h=WIDGET_H(c)+bh+2*bw;
+
+    XDrawRectangle(xinfo.display, xinfo.root_win, gc, x+lw/2, y+lw/2, w-lw, h-lw);
+}
+
 static Delta_rect get_pointer_delta_rect(const Move_info *m, Pointer_act act)
 {
     int dx=m->nx-m->ox, dy=m->ny-m->oy;
@@ -172,11 +270,11 @@ static Delta_rect get_pointer_delta_rect(const Move_info *m, Pointer_act act)
     return dr[act];
 }
 
-static bool get_move_resize_delta_rect(Client *c, Delta_rect *d, bool is_move, bool is_to_float)
+static bool get_move_resize_delta_rect(Client *c, const XSizeHints *hint, Delta_rect *d, bool is_move, bool is_to_float)
 {
     if(is_to_float)
-        return fix_first_move_resize(c, d);
-    return (is_move && is_prefer_move(c, d)) || fix_delta_rect(c, d);
+        return fix_first_move_resize(c, hint, d);
+    return (is_move && is_prefer_move(c, d)) || fix_delta_rect(c, hint, d);
 }
 
 static bool is_prefer_move(Client *c, Delta_rect *d)
@@ -184,15 +282,14 @@ static bool is_prefer_move(Client *c, Delta_rect *d)
     return is_on_screen(WIDGET_X(c)+d->dx, WIDGET_Y(c)+d->dy, WIDGET_W(c), WIDGET_H(c));
 }
 
-static bool fix_delta_rect(Client *c, Delta_rect *d)
+static bool fix_delta_rect(Client *c, const XSizeHints *hint, Delta_rect *d)
 {
     int dw=d->dw, dh=d->dh;
-    XSizeHints hint=get_size_hint(WIDGET_WIN(c));
 
-    fix_dw_by_width_hint(WIDGET_W(c), &hint, &dw);
-    fix_dh_by_height_hint(WIDGET_W(c), &hint, &dh);
+    fix_dw_by_width_hint(WIDGET_W(c), hint, &dw);
+    fix_dh_by_height_hint(WIDGET_W(c), hint, &dh);
 
-    if((!dw && !dh) || !is_prefer_size(WIDGET_W(c)+dw, WIDGET_H(c)+dh, &hint))
+    if((!dw && !dh) || !is_prefer_size(WIDGET_W(c)+dw, WIDGET_H(c)+dh, hint))
         return false;
 
     d->dw=dw, d->dh=dh;
@@ -203,7 +300,7 @@ static bool fix_delta_rect(Client *c, Delta_rect *d)
     return true;
 }
 
-static void fix_dw_by_width_hint(int w, XSizeHints *hint, int *dw)
+static void fix_dw_by_width_hint(int w, const XSizeHints *hint, int *dw)
 {
     if(hint->width_inc && *dw/hint->width_inc)
     {
@@ -216,7 +313,7 @@ static void fix_dw_by_width_hint(int w, XSizeHints *hint, int *dw)
         *dw=0;
 }
 
-static void fix_dh_by_height_hint(int h, XSizeHints *hint, int *dh)
+static void fix_dh_by_height_hint(int h, const XSizeHints *hint, int *dh)
 {
     if(hint->height_inc && *dh/hint->height_inc)
     {
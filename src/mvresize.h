@@ -22,7 +22,7 @@ typedef enum // 鍵盤操作方式
 } Key_act;
 
 void key_move_resize_client(XEvent *e, Key_act op);
-void pointer_move_resize_client(XEvent *e, bool resize);
+void pointer_move_resize_client(XEvent *e, bool resize, bool outline);
 Pointer_act get_resize_act(Client *c, int x, int y);
 
 #endif
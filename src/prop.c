@@ -331,27 +331,51 @@ static unsigned long get_strings_size(const char **strs, int n)
 
 void copy_prop(Window dest, Window src)
 {
-    int i=0, n=0, fmt=0;
-    Atom type, *props=XListProperties(xinfo.display, src, &n);
+    int n=0;
+    Atom *props=XListProperties(xinfo.display, src, &n);
 
     if(!props)
         return;
 
-    unsigned long nitems, rest;
-    for(unsigned char *data=NULL; i<n; i++)
-    {
-        if( XGetWindowProperty(xinfo.display, src, props[i], 0, ~0L, False,
-            AnyPropertyType, &type, &fmt, &nitems, &rest, &data)==Success
-            && data && nitems)
-        {
-            XChangeProperty(xinfo.display, dest, props[i], type, fmt,
-                PropModeReplace, data, nitems);
-            XFree(data);
-        }
-    }
+    for(int i=0; i<n; i++)
+        copy_spec_prop(dest, src, props[i]);
     XFree(props);
 }
 
+void delete_all_props(Window win)
+{
+    int n=0;
+    Atom *props=XListProperties(xinfo.display, win, &n);
+
+    if(!props)
+        return;
+
+    for(int i=0; i<n; i++)
+        XDeleteProperty(xinfo.display, win, props[i]);
+    XFree(props);
+}
+
+// 只複製src的prop屬性，prop已被刪除時亦刪除dest的相應屬性
+void copy_spec_prop(Window dest, Window src, Atom prop)
+{
+    int fmt=0;
+    Atom type=None;
+    unsigned long nitems=0, rest=0;
+    unsigned char *data=NULL;
+
+    if( XGetWindowProperty(xinfo.display, src, prop, 0, ~0L, False,
+        AnyPropertyType, &type, &fmt, &nitems, &rest, &data) != Success)
+        return;
+
+    if(type == None)
+        XDeleteProperty(xinfo.display, dest, prop);
+    else if(data && nitems)
+        XChangeProperty(xinfo.display, dest, prop, type, fmt,
+            PropModeReplace, data, nitems);
+    if(data)
+        XFree(data);
+}
+
 void set_gwm_layout(int layout)
 {
     replace_cardinal_prop(xinfo.root_win, gwm_atoms[GWM_LAYOUT], layout);
@@ -362,11 +386,6 @@ int get_gwm_layout(void)
     return get_cardinal_prop(xinfo.root_win, gwm_atoms[GWM_LAYOUT], 0);
 }
 
-void request_layout_update(void)
-{
-    replace_cardinal_prop(xinfo.root_win, gwm_atoms[GWM_UPDATE_LAYOUT], 1);
-}
-
 void set_main_color_name(const char *name)
 {
     replace_utf8_prop(xinfo.root_win, gwm_atoms[GWM_MAIN_COLOR_NAME], name);
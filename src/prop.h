@@ -48,9 +48,10 @@ void replace_cardinals_prop(Window win, Atom prop, const long values[], int n);
 void replace_utf8_prop(Window win, Atom prop, const void *str);
 void replace_utf8s_prop(Window win, Atom prop, const void *strs, int n);
 void copy_prop(Window dest, Window src);
+void copy_spec_prop(Window dest, Window src, Atom prop);
+void delete_all_props(Window win);
 void set_gwm_layout(int layout);
 int get_gwm_layout(void);
-void request_layout_update(void);
 void set_main_color_name(const char *name);
 char *get_main_color_name(void);
 
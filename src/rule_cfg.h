@@ -23,15 +23,20 @@
  * 一個窗口可以歸屬多個桌面，桌面從0開始編號，桌面n的掩碼計算公式：1<<n。
  * 譬如，桌面0的掩碼是1<<0，即1；桌面1的掩碼是1<<1，即2；1&2即3表示窗口歸屬桌面0和1。
  * 若掩碼爲0，表示窗口歸屬默認桌面。
+ * 以輪廓方式移動和調整尺寸時，拖動過程中只畫出窗口輪廓，鬆開定位器按鈕後纔真正
+ * 移動和調整窗口，適用於重新布局代價高昂的程序（如瀏覽器、集成開發環境）。各規
+ * 則默認不啓用此方式，若需要，可把相應規則的最後一列改爲true，如把下面的firefox
+ * 規則改爲：
+ *     {"org.mozilla.firefox", "Toolkit", "*", NORMAL_LAYER, ANY_AREA, 0, false, true},
  */
 static const Rule rules[] =
 {
-    /* 客戶程序類型         客戶程序名稱    標題   窗口所在層    窗口所在區  桌面掩碼  是否遵從最大最小尺寸 */
-    {"wesnoth",             "wesnoth",      "*",   NORMAL_LAYER, MAIN_AREA,  0,         true  },
-    {"QQ",                  "qq",           "QQ",  NORMAL_LAYER, FIXED_AREA, 0,         false },
-    {"explorer.exe",        "explorer.exe", "*",   ABOVE_LAYER,  ANY_AREA,   0,         false },
-    {"Thunder.exe",         "Thunder.exe",  "*",   ABOVE_LAYER,  ANY_AREA,   0,         false },
-    {"org.mozilla.firefox", "Toolkit",      "*",   NORMAL_LAYER, ANY_AREA,   0,         false },
+    /* 客戶程序類型         客戶程序名稱    標題   窗口所在層    窗口所在區  桌面掩碼  是否遵從最大最小尺寸 是否以輪廓移動和調整尺寸 */
+    {"wesnoth",             "wesnoth",      "*",   NORMAL_LAYER, MAIN_AREA,  0,         true,                false },
+    {"QQ",                  "qq",           "QQ",  NORMAL_LAYER, FIXED_AREA, 0,         false,               false },
+    {"explorer.exe",        "explorer.exe", "*",   ABOVE_LAYER,  ANY_AREA,   0,         false,               false },
+    {"Thunder.exe",         "Thunder.exe",  "*",   ABOVE_LAYER,  ANY_AREA,   0,         false,               false },
+    {"org.mozilla.firefox", "Toolkit",      "*",   NORMAL_LAYER, ANY_AREA,   0,         false,               false },
     {0} // 哨兵值，表示結束，切勿刪改之
 };
 
@@ -0,0 +1,297 @@
+/* *************************************************************************
+ *     screenshot.c：實現截圖功能。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+
+#define _GNU_SOURCE // 爲了使用pipe2
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <png.h>
+#include <Imlib2.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include "config.h"
+#include "drawable.h"
+#include "file.h"
+#include "taskbar.h"
+#include "misc.h"
+#include "screenshot.h"
+
+/* 截圖分兩步：事件線程經由MIT-SHM共享內存截取像素並轉換爲ARGB格式，隨即返回；
+ * PNG壓縮和寫文件則交給工作線程。工作線程完成後經管道把結果交回事件線程，由
+ * 事件線程在狀態欄顯示通知，因爲只有事件線程纔能訪問X */
+typedef struct // 截圖任務
+{
+    DATA32 *data; // ARGB像素
+    int w, h;
+    char *filename;
+    bool ok; // 是否已成功寫入文件
+} Screenshot;
+
+static bool have_shm=false; // X服務器是否支持MIT-SHM擴展
+static int notify_fds[2]={-1, -1}; // 工作線程向事件線程通知結果的管道
+static size_t npending=0; // 尚未完成的截圖任務數量
+
+static XImage *get_image(Drawable d, int x, int y, int w, int h);
+static XImage *get_shm_image(Drawable d, Visual *visual, int depth, int x, int y, int w, int h);
+static void destroy_image(XImage *image);
+static DATA32 *image_to_argb(XImage *image);
+static int get_mask_shift(unsigned long mask);
+static char *get_screenshot_filename(void);
+static void *save_png(void *arg);
+static bool write_png(const Screenshot *s);
+static void save_by_imlib(Screenshot *s);
+static void notify_screenshot(const Screenshot *s);
+
+void init_screenshot(void)
+{
+    have_shm=XShmQueryExtension(xinfo.display);
+    if(pipe2(notify_fds, O_CLOEXEC))
+        perror(_("未能成功地創建截圖通知管道"));
+}
+
+/* 等待尚未完成的截圖任務，以免退出時截圖文件不完整 */
+void deinit_screenshot(void)
+{
+    while(npending && notify_fds[0]>=0)
+        handle_screenshot_notify();
+    for(size_t i=0; i<ARRAY_NUM(notify_fds); i++)
+        if(notify_fds[i] >= 0)
+            close(notify_fds[i]), notify_fds[i]=-1;
+}
+
+int get_screenshot_notify_fd(void)
+{
+    return notify_fds[0];
+}
+
+void print_area(Drawable d, int x, int y, int w, int h)
+{
+    XImage *image=get_image(d, x, y, w, h);
+    if(!image)
+        return;
+
+    Screenshot *s=Malloc(sizeof(Screenshot));
+    *s=(Screenshot){image_to_argb(image), w, h, get_screenshot_filename(), false};
+    destroy_image(image);
+
+    pthread_t tid;
+    if( strcmp(cfg->screenshot_format, "png") || notify_fds[1]<0
+        || pthread_create(&tid, NULL, save_png, s))
+    {   // 非PNG格式由Imlib2在事件線程內保存
+        save_by_imlib(s);
+        notify_screenshot(s);
+        vfree(s->data, s->filename, s);
+    }
+    else
+        pthread_detach(tid), npending++;
+}
+
+static XImage *get_image(Drawable d, int x, int y, int w, int h)
+{
+    XWindowAttributes a;
+    XImage *image=NULL;
+
+    if(!XGetWindowAttributes(xinfo.display, d, &a))
+        return NULL;
+    if(have_shm)
+        image=get_shm_image(d, a.visual, a.depth, x, y, w, h);
+    return image ? image : XGetImage(xinfo.display, d, x, y, w, h, AllPlanes, ZPixmap);
+}
+
+static XImage *get_shm_image(Drawable d, Visual *visual, int depth, int x, int y, int w, int h)
+{
+    XShmSegmentInfo *shm=Malloc(sizeof(XShmSegmentInfo));
+    XImage *image=XShmCreateImage(xinfo.display, visual, depth, ZPixmap, NULL, shm, w, h);
+
+    if(!image)
+    {
+        Free(shm);
+        return NULL;
+    }
+
+    shm->shmid=shmget(IPC_PRIVATE, image->bytes_per_line*image->height, IPC_CREAT|0600);
+    if(shm->shmid < 0)
+    {
+        XDestroyImage(image), Free(shm);
+        return NULL;
+    }
+
+    shm->shmaddr=image->data=shmat(shm->shmid, NULL, 0);
+    shmctl(shm->shmid, IPC_RMID, NULL); // 雙方都分離後自動刪除
+    shm->readOnly=False;
+    image->obdata=(char *)shm;
+    if( shm->shmaddr == (char *)-1 || !XShmAttach(xinfo.display, shm)
+        || !XShmGetImage(xinfo.display, d, image, x, y, AllPlanes))
+    {
+        if(shm->shmaddr != (char *)-1)
+            XShmDetach(xinfo.display, shm), XSync(xinfo.display, False), shmdt(shm->shmaddr);
+        image->data=NULL, image->obdata=NULL;
+        XDestroyImage(image), Free(shm);
+        return NULL;
+    }
+
+    return image;
+}
+
+static void destroy_image(XImage *image)
+{
+    XShmSegmentInfo *shm=(XShmSegmentInfo *)image->obdata;
+
+    if(shm)
+    {
+        XShmDetach(xinfo.display, shm);
+        XSync(xinfo.display, False);
+        shmdt(shm->shmaddr);
+        image->data=NULL, image->obdata=NULL;
+        Free(shm);
+    }
+    XDestroyImage(image);
+}
+
+/* 常見的32位像素且掩碼爲標準RGB時直接逐字轉換，否則按掩碼提取各顏色分量 */
+static DATA32 *image_to_argb(XImage *image)
+{
+    int w=image->width, h=image->height;
+    DATA32 *data=Malloc((size_t)w*h*sizeof(DATA32)), *p=data;
+    unsigned long rm=image->red_mask, gm=image->green_mask, bm=image->blue_mask;
+    int rs=get_mask_shift(rm), gs=get_mask_shift(gm), bs=get_mask_shift(bm);
+    bool fast = image->bits_per_pixel==32 && rm==0xff0000 && gm==0xff00 && bm==0xff
+        && image->byte_order==(*(const char *)&(int){1} ? LSBFirst : MSBFirst);
+
+    for(int y=0; y<h; y++)
+    {
+        const DATA32 *row=(const DATA32 *)(image->data+y*image->bytes_per_line);
+        for(int x=0; x<w; x++)
+        {
+            if(fast)
+                *p++=row[x]|0xff000000;
+            else
+            {
+                unsigned long pixel=XGetPixel(image, x, y);
+                unsigned long r=(pixel&rm)>>rs, g=(pixel&gm)>>gs, b=(pixel&bm)>>bs;
+                r=r*255/((rm>>rs) ? rm>>rs : 1);
+                g=g*255/((gm>>gs) ? gm>>gs : 1);
+                b=b*255/((bm>>bs) ? bm>>bs : 1);
+                *p++=0xff000000|(r<<16)|(g<<8)|b;
+            }
+        }
+    }
+
+    return data;
+}
+
+static int get_mask_shift(unsigned long mask)
+{
+    int shift=0;
+    for(; mask && !(mask&1); mask>>=1)
+        shift++;
+    return shift;
+}
+
+static char *get_screenshot_filename(void)
+{
+    time_t timer=time(NULL), err=-1;
+    char name[FILENAME_MAX];
+
+    if(cfg->screenshot_path[0] == '~')
+        sprintf(name, "%s%s/gwm-", getenv("HOME"), cfg->screenshot_path+1);
+    else
+        sprintf(name, "%s/gwm-", cfg->screenshot_path);
+    if(timer != err)
+        strftime(name+strlen(name), FILENAME_MAX, "%Y_%m_%d_%H_%M_%S", localtime(&timer));
+    sprintf(name+strlen(name), ".%s", cfg->screenshot_format);
+    return copy_string(name);
+}
+
+/* 工作線程：不得調用Xlib和Imlib2函數 */
+static void *save_png(void *arg)
+{
+    Screenshot *s=arg;
+
+    s->ok=write_png(s);
+    while(write(notify_fds[1], &s, sizeof(s))<0 && errno==EINTR)
+        ;
+    return NULL;
+}
+
+static bool write_png(const Screenshot *s)
+{
+    FILE *fp=fopen(s->filename, "wbe");
+    if(!fp)
+        return false;
+
+    png_structp png=png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_infop info = png ? png_create_info_struct(png) : NULL;
+    png_bytep row=Malloc((size_t)s->w*3);
+    bool ok=false;
+
+    if(info && !setjmp(png_jmpbuf(png)))
+    {
+        png_init_io(png, fp);
+        png_set_IHDR(png, info, s->w, s->h, 8, PNG_COLOR_TYPE_RGB,
+            PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+        png_write_info(png, info);
+        for(int y=0; y<s->h; y++)
+        {
+            const DATA32 *p=s->data+(size_t)y*s->w;
+            for(int x=0; x<s->w; x++)
+                row[3*x]=p[x]>>16, row[3*x+1]=p[x]>>8, row[3*x+2]=p[x];
+            png_write_row(png, row);
+        }
+        png_write_end(png, NULL);
+        ok=true;
+    }
+    png_destroy_write_struct(&png, &info);
+    Free(row);
+    return fclose(fp)==0 && ok;
+}
+
+static void save_by_imlib(Screenshot *s)
+{
+    Imlib_Image image=imlib_create_image_using_data(s->w, s->h, s->data);
+    if(!image)
+        return;
+
+    imlib_context_set_image(image);
+    imlib_image_set_format(cfg->screenshot_format);
+    imlib_save_image(s->filename);
+    imlib_free_image();
+    s->ok=is_accessible(s->filename);
+}
+
+/* 事件線程在截圖通知管道可讀時調用 */
+void handle_screenshot_notify(void)
+{
+    Screenshot *s=NULL;
+
+    if(read(notify_fds[0], &s, sizeof(s)) != sizeof(s))
+        return;
+
+    npending--;
+    notify_screenshot(s);
+    vfree(s->data, s->filename, s);
+}
+
+static void notify_screenshot(const Screenshot *s)
+{
+    char *msg=copy_strings(s->ok ? _("截圖已保存到：") : _("未能保存截圖："),
+        s->filename, NULL);
+    taskbar_change_statusbar_label(msg);
+    Free(msg);
+}
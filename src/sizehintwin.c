@@ -9,43 +9,73 @@
  * <http://www.gnu.org/licenses/>。
  * ************************************************************************/
 
+#include <string.h>
 #include "gwm.h"
 #include "misc.h"
 #include "icccm.h"
 #include "font.h"
 #include "config.h"
+#include "xres.h"
 #include "sizehintwin.h"
 
+/* 移動、調整窗口尺寸時，尺寸提示窗口顯示窗口的坐標和以尺寸增量爲單位的行列
+ * 數。它在首次使用時創建，此後每次操作只重新定位和顯示。各字符按等寬的格子
+ * 排列，字形預先畫在一個pixmap條帶上，更新時只把與上次不同的格子從條帶上複製
+ * 到窗口，而不必每次都清空窗口並用Xft重畫整個字符串 */
 #define SIZE_HINT_INFO_MAX 32
+#define SIZE_HINT_CHARS " 0123456789-(),x" // 信息中可能出現的字符，首個必須爲空格
+#define SIZE_HINT_TEMPLATE "(-0000, -0000) 0000x0000" // 決定窗口能容納的格子數
 
 struct _size_hint_win_tag
 {
     Widget base;
     Widget *hint_for;
-    char info[SIZE_HINT_INFO_MAX];
+    XSizeHints hint; // 本次操作中hint_for的尺寸特性
+    char info[SIZE_HINT_INFO_MAX]; // 窗口上已顯示的信息
+    Pixmap strip; // 字形條帶
+    int cell_w; // 格子寬度
+    unsigned long strip_bg, strip_fg; // 繪製字形條帶時所用的背景色和前景色
 };
 
-static void size_hint_win_ctor(Size_hint_win *size_hint_win, Widget *hint_for);
+static Size_hint_win *size_hint_win=NULL;
+
+static Size_hint_win *size_hint_win_new(void);
+static void size_hint_win_ctor(Size_hint_win *size_hint_win);
 static void size_hint_win_set_method(Widget *widget);
-static void size_hint_win_set_info(Size_hint_win *size_hint_win);
+static void size_hint_win_draw(Size_hint_win *size_hint_win, bool full);
+static void size_hint_win_set_info(const Size_hint_win *size_hint_win, char *info);
+static bool size_hint_win_update_strip(Size_hint_win *size_hint_win);
+static void size_hint_win_draw_cell(const Size_hint_win *size_hint_win, size_t i, char ch);
+static int get_cell_w(void);
 
-Size_hint_win *size_hint_win_new(Widget *hint_for)
+static Size_hint_win *size_hint_win_new(void)
 {
     Size_hint_win *size_hint_win=Malloc(sizeof(Size_hint_win));
-    size_hint_win_ctor(size_hint_win, hint_for);
+    size_hint_win_ctor(size_hint_win);
     return size_hint_win;
 }
 
-static void size_hint_win_ctor(Size_hint_win *size_hint_win, Widget *hint_for)
+static void size_hint_win_ctor(Size_hint_win *size_hint_win)
 {
-    int x, y, w, h=get_font_height_by_pad();
+    int cw=get_cell_w(), w=cw*(strlen(SIZE_HINT_TEMPLATE)+2),
+        h=get_font_height_by_pad();
 
-    get_string_size(" (xxxx, yyyy) wwww, hhhh ", &w, NULL);
-    x=(WIDGET_W(hint_for)-w)/2, y=(WIDGET_H(hint_for)-h)/2;
-    widget_ctor(WIDGET(size_hint_win), NULL, WIDGET_TYPE_SIZE_HINT_WIN, UNUSED_WIDGET_ID, x, y, w, h);
+    widget_ctor(WIDGET(size_hint_win), NULL, WIDGET_TYPE_SIZE_HINT_WIN, UNUSED_WIDGET_ID, 0, 0, w, h);
     size_hint_win_set_method(WIDGET(size_hint_win));
-    size_hint_win->hint_for=hint_for;
-    size_hint_win_set_info(size_hint_win);
+    size_hint_win->hint_for=NULL;
+    size_hint_win->info[0]='\0';
+    size_hint_win->strip=None;
+    size_hint_win->cell_w=cw;
+}
+
+static int get_cell_w(void)
+{
+    int w, max=0;
+    char s[2]={0};
+
+    for(const char *p=SIZE_HINT_CHARS; *p; p++)
+        s[0]=*p, get_string_size(s, &w, NULL), max=MAX(max, w);
+    return max;
 }
 
 static void size_hint_win_set_method(Widget *widget)
@@ -53,29 +83,114 @@ static void size_hint_win_set_method(Widget *widget)
     widget->update_fg=size_hint_win_update_fg;
 }
 
+/* 開始一次移動或調整尺寸操作，hint爲hint_for在本次操作中的尺寸特性 */
+void size_hint_win_begin(Widget *hint_for, const XSizeHints *hint)
+{
+    if(!size_hint_win)
+        size_hint_win=size_hint_win_new();
+
+    Widget *widget=WIDGET(size_hint_win);
+    int w=WIDGET_W(widget), h=WIDGET_H(widget);
+
+    size_hint_win->hint_for=hint_for;
+    size_hint_win->hint=*hint;
+    widget_move_resize(widget, (WIDGET_W(hint_for)-w)/2,
+        (WIDGET_H(hint_for)-h)/2, w, h);
+    XMapRaised(xinfo.display, WIDGET_WIN(widget));
+    size_hint_win_draw(size_hint_win, true);
+}
+
+void size_hint_win_end(void)
+{
+    if(size_hint_win)
+        widget_hide(WIDGET(size_hint_win)), size_hint_win->hint_for=NULL;
+}
+
+void free_size_hint_win(void)
+{
+    if(!size_hint_win)
+        return;
+    if(size_hint_win->strip)
+        free_pixmap(size_hint_win->strip);
+    widget_del(WIDGET(size_hint_win)), size_hint_win=NULL;
+}
+
 void size_hint_win_update_fg(const Widget *widget)
 {
-    Size_hint_win *size_hint_win=SIZE_HINT_WIN(widget);
-    Str_fmt f={0, 0, WIDGET_W(widget), WIDGET_H(widget), CENTER,
-        true, false, 0, get_text_color(widget)};
+    size_hint_win_draw(SIZE_HINT_WIN(widget), true);
+}
 
-    draw_string(WIDGET_WIN(widget), size_hint_win->info, &f);
+void size_hint_win_update(void)
+{
+    if(size_hint_win)
+        size_hint_win_draw(size_hint_win, false);
 }
 
-void size_hint_win_update(Size_hint_win *size_hint_win)
+/* full爲true時重畫所有格子，否則只重畫與已顯示的信息不同的格子 */
+static void size_hint_win_draw(Size_hint_win *size_hint_win, bool full)
 {
-    widget_show(WIDGET(size_hint_win));
-    size_hint_win_set_info(size_hint_win);
-    size_hint_win_update_fg(WIDGET(size_hint_win));
+    char info[SIZE_HINT_INFO_MAX]={0}, *old=size_hint_win->info;
+    size_t n=strlen(SIZE_HINT_TEMPLATE);
+
+    if(!size_hint_win->hint_for)
+        return;
+
+    if(size_hint_win_update_strip(size_hint_win))
+        full=true;
+    size_hint_win_set_info(size_hint_win, info);
+    for(size_t i=0; i<n; i++)
+    {
+        char oc = i<strlen(old) ? old[i] : ' ', nc = i<strlen(info) ? info[i] : ' ';
+        if(full || oc!=nc)
+            size_hint_win_draw_cell(size_hint_win, i, nc);
+    }
+    strcpy(old, info);
 }
 
-static void size_hint_win_set_info(Size_hint_win *size_hint_win)
+static void size_hint_win_set_info(const Size_hint_win *size_hint_win, char *info)
 {
-    XSizeHints hint=get_size_hint(WIDGET_WIN(size_hint_win->hint_for));
+    const XSizeHints *hint=&size_hint_win->hint;
     Widget *widget=size_hint_win->hint_for;
-    long col=get_win_col(WIDGET_W(widget), &hint),
-         row=get_win_row(WIDGET_H(widget), &hint);
+    int col=get_win_col(WIDGET_W(widget), hint),
+        row=get_win_row(WIDGET_H(widget), hint);
 
-    sprintf(size_hint_win->info, "(%d, %d) %ldx%ld",
+    snprintf(info, SIZE_HINT_INFO_MAX, "(%d, %d) %dx%d",
         WIDGET_X(widget), WIDGET_Y(widget), col, row);
 }
+
+/* 字形條帶在首次使用或界面顏色改變後重畫，重畫時返回true */
+static bool size_hint_win_update_strip(Size_hint_win *size_hint_win)
+{
+    Widget *widget=WIDGET(size_hint_win);
+    int cw=size_hint_win->cell_w, h=WIDGET_H(widget), n=strlen(SIZE_HINT_CHARS);
+    unsigned long bg=get_widget_color(widget);
+    XftColor fg=get_text_color(widget);
+    char s[2]={0};
+
+    if( size_hint_win->strip && bg==size_hint_win->strip_bg
+        && fg.pixel==size_hint_win->strip_fg)
+        return false;
+
+    if(!size_hint_win->strip)
+        size_hint_win->strip=create_pixmap(WIDGET_WIN(widget), cw*n, h,
+            xinfo.depth, "size_hint_win");
+    for(int i=0; i<n; i++)
+    {
+        Str_fmt f={cw*i, 0, cw, h, CENTER, false, true, bg, fg};
+        s[0]=SIZE_HINT_CHARS[i];
+        draw_string(size_hint_win->strip, s, &f);
+    }
+    size_hint_win->strip_bg=bg, size_hint_win->strip_fg=fg.pixel;
+    return true;
+}
+
+/* 第i個格子位於左右各留一個格子寬的邊距之後 */
+static void size_hint_win_draw_cell(const Size_hint_win *size_hint_win, size_t i, char ch)
+{
+    const char *p=strchr(SIZE_HINT_CHARS, ch);
+    int cw=size_hint_win->cell_w, h=WIDGET_H(size_hint_win),
+        k = p ? p-SIZE_HINT_CHARS : 0;
+
+    XCopyArea(xinfo.display, size_hint_win->strip, WIDGET_WIN(size_hint_win),
+        get_depth_gc(xinfo.depth), cw*k, 0, cw, h, cw*(i+1), 0);
+}
@@ -12,13 +12,16 @@
 #ifndef SIZEHINTWIN_H
 #define SIZEHINTWIN_H
 
+#include <X11/Xutil.h>
 #include "widget.h"
 
 typedef struct _size_hint_win_tag Size_hint_win;
 
 #define SIZE_HINT_WIN(widget) ((Size_hint_win *)(widget))
 
-Size_hint_win *size_hint_win_new(Widget *hint_for);
+void size_hint_win_begin(Widget *hint_for, const XSizeHints *hint);
+void size_hint_win_end(void);
+void free_size_hint_win(void);
 void size_hint_win_update_fg(const Widget *widget);
-void size_hint_win_update(Size_hint_win *size_hint_win);
+void size_hint_win_update(void);
 #endif
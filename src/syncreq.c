@@ -0,0 +1,136 @@
+/* *************************************************************************
+ *     syncreq.c：實現EWMH的_NET_WM_SYNC_REQUEST協議。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include <sys/select.h>
+#include "config.h"
+#include "misc.h"
+#include "ewmh.h"
+#include "syncreq.h"
+
+/* 交互式調整窗口尺寸時，WM會連續不斷地發送配置請求，而客戶往往來不及重繪，從而
+ * 導致畫面撕裂、CPU佔用飆升。按照EWMH的_NET_WM_SYNC_REQUEST協議，WM在每次配置
+ * 客戶窗口之前先把一個遞增的序號發給客戶，客戶重繪完成後把其XSync計數器設置爲該
+ * 序號。WM則在計數器上設置一個報警器，收到報警事件後纔發送下一次配置請求。爲防
+ * 止無響應的客戶拖慢WM，等待時間不超過cfg->sync_request_timeout毫秒。詳見：
+ *     https://specifications.freedesktop.org/wm-spec/latest/ar01s06.html
+ */
+
+static bool wait_alarm_notify(const Client *c, struct timeval *timeout);
+static Bool is_alarm_notify(Display *display, XEvent *e, XPointer arg);
+
+static bool have_sync_ext=false; // X服務器是否支持XSync擴展
+static int sync_event_base=0; // XSync擴展的事件基值
+
+void init_sync_request(void)
+{
+    int error_base, major, minor;
+
+    have_sync_ext=XSyncQueryExtension(xinfo.display, &sync_event_base, &error_base)
+        && XSyncInitialize(xinfo.display, &major, &minor);
+}
+
+/* 是否在WM_PROTOCOLS中聲明了支持本協議只在此檢查一次，sync_counter非None即
+ * 表示支持，以免每次調整尺寸都要與X服務器往返通信 */
+void set_client_sync_counter(Client *c)
+{
+    XSyncAlarmAttributes a;
+    unsigned long mask=XSyncCACounter|XSyncCAValueType|XSyncCAValue
+        |XSyncCATestType|XSyncCADelta|XSyncCAEvents;
+
+    c->sync_counter=None, c->sync_alarm=None;
+    XSyncIntToValue(&c->sync_value, 0);
+    if( !have_sync_ext || cfg->sync_request_timeout<=0
+        || !(c->sync_counter=get_net_wm_sync_request_counter(WIDGET_WIN(c))))
+        return;
+
+    if(!XSyncQueryCounter(xinfo.display, c->sync_counter, &c->sync_value))
+        { c->sync_counter=None; return; }
+
+    a.trigger.counter=c->sync_counter;
+    a.trigger.value_type=XSyncAbsolute;
+    a.trigger.wait_value=c->sync_value;
+    a.trigger.test_type=XSyncPositiveComparison;
+    XSyncIntToValue(&a.delta, 0);
+    a.events=True;
+    c->sync_alarm=XSyncCreateAlarm(xinfo.display, mask, &a);
+    if(c->sync_alarm == None)
+        c->sync_counter=None;
+}
+
+void unset_client_sync_counter(Client *c)
+{
+    if(c->sync_alarm)
+        XSyncDestroyAlarm(xinfo.display, c->sync_alarm);
+    c->sync_counter=None, c->sync_alarm=None;
+}
+
+/* 發送下一個同步序號，並把報警器的觸發值設爲該序號。返回是否需要等待客戶 */
+bool request_client_sync(Client *c)
+{
+    if(!c->sync_counter)
+        return false;
+
+    int overflow=0;
+    XSyncValue one;
+    XSyncAlarmAttributes a;
+
+    XSyncIntToValue(&one, 1);
+    XSyncValueAdd(&c->sync_value, c->sync_value, one, &overflow);
+    if(overflow)
+        XSyncIntToValue(&c->sync_value, 0);
+    if(!send_net_wm_sync_request(WIDGET_WIN(c),
+        XSyncValueLow32(c->sync_value), XSyncValueHigh32(c->sync_value)))
+        return false;
+
+    a.trigger.wait_value=c->sync_value;
+    XSyncChangeAlarm(xinfo.display, c->sync_alarm, XSyncCAValue, &a);
+    return true;
+}
+
+/* 等待客戶完成重繪，超時則返回假 */
+bool wait_client_sync(const Client *c)
+{
+    int ms=cfg->sync_request_timeout;
+    struct timeval t={ms/1000, ms%1000*1000};
+
+    return c->sync_alarm && wait_alarm_notify(c, &t);
+}
+
+/* 此前超時的等待所對應的報警事件可能遲到，其計數器值小於c->sync_value，須忽略 */
+static bool wait_alarm_notify(const Client *c, struct timeval *timeout)
+{
+    int fd=ConnectionNumber(xinfo.display);
+    XEvent ev;
+    fd_set fds;
+
+    XFlush(xinfo.display);
+    while(1)
+    {
+        // 只取出本報警器的報警事件，其他事件留待調用者處理
+        while(XCheckIfEvent(xinfo.display, &ev, is_alarm_notify, (XPointer)c))
+            if(XSyncValueGreaterOrEqual(((XSyncAlarmNotifyEvent *)&ev)->counter_value,
+                c->sync_value))
+                return true;
+
+        FD_ZERO(&fds);
+        FD_SET(fd, &fds);
+        // 同event.c，依賴於linux的select會把剩餘時間寫回timeout
+        if(select(fd+1, &fds, 0, 0, timeout) <= 0)
+            return false;
+    }
+}
+
+static Bool is_alarm_notify(Display *display, XEvent *e, XPointer arg)
+{
+    UNUSED(display);
+    return e->type==sync_event_base+XSyncAlarmNotify
+        && ((XSyncAlarmNotifyEvent *)e)->alarm==((const Client *)arg)->sync_alarm;
+}
@@ -9,6 +9,7 @@
  * <http://www.gnu.org/licenses/>。
  * ************************************************************************/
 
+#include <string.h>
 #include <X11/Xatom.h>
 #include "button.h"
 #include "misc.h"
@@ -21,12 +22,22 @@
 #include "ewmh.h"
 #include "drawable.h"
 #include "tooltip.h"
+#include "xres.h"
 #include "taskbar.h"
 
+/* 縮微窗口欄只有一個窗口，各縮微窗口按鈕不另設窗口，而是先畫在後備緩衝區上
+ * 再一次性複製到窗口，並在進程內按橫坐標判斷定位器所指的按鈕。同類窗口的按
+ * 鈕相鄰排列。容納不下的按鈕不顯示，而在欄的右端顯示溢出指示區，可用滾輪或
+ * 單擊該區翻看 */
 typedef struct // 縮微窗口按鈕
 {
-    Button *button;
     Window cwin; // 縮微客戶窗口
+    char *title; // 圖符標題
+    char *class_name; // 窗口類型
+    char *icon_name; // 無圖標映像時以其首字符作圖標
+    Imlib_Image image;
+    int label_w; // 標題的寬度
+    int x, w; // 在縮微窗口欄中的橫坐標和寬度，x爲負表示未顯示
     List list;
 } Cbutton;
 
@@ -34,6 +45,12 @@ typedef struct // 縮微窗口欄
 {
     Widget base;
     Cbutton *cbuttons;
+    Cbutton *hot; // 定位器所指的按鈕
+    bool more_hot; // 定位器是否指向溢出指示區
+    int first; // 首個顯示的按鈕的序號
+    int more_x; // 溢出指示區的橫坐標，爲負表示沒有溢出
+    int hidden_n; // 未顯示的按鈕數
+    Pixmap buf; // 後備緩衝區
 } Iconbar;
 
 typedef struct // 狀態欄
@@ -50,6 +67,7 @@ struct _taskbar_tag // 任務欄
     Iconbar *iconbar;
     Statusbar *statusbar;
     Menu *act_center;
+    bool frozen, stale; // 是否暫停更新（如被全屏窗口遮擋時）、暫停期間是否有內容變化
 };
 
 static void taskbar_ctor(Widget *parent, int x, int y, int w, int h);
@@ -61,12 +79,12 @@ static void taskbar_buttons_new(void);
 static void taskbar_buttons_del(void);
 static bool taskbar_button_is_chosen(Widget_id id);
 static void taskbar_buttons_update_bg(void);
-static Cbutton *cbutton_new(Widget *parent, int x, int y, int w, int h, Window cwin);
+static Cbutton *cbutton_new(Window cwin);
 static void cbutton_del(Cbutton *cbutton);
-static void cbutton_ctor(Cbutton *cbutton, Widget *parent, int x, int y, int w, int h, Window cwin);
-static void cbutton_dtor(Cbutton *cbutton);
-static void cbutton_set_icon(Cbutton *cbutton);
+static void cbutton_set_title(Cbutton *cbutton, const char *title);
+static bool is_same_class(const Cbutton *a, const Cbutton *b);
 static Cbutton *iconbar_find_cbutton(const Iconbar *iconbar, Window cwin);
+static Cbutton *iconbar_find_cbutton_by_x(const Iconbar *iconbar, int x);
 static Iconbar *iconbar_new(Widget *parent, int x, int y, int w, int h);
 static void iconbar_ctor(Iconbar *iconbar, Widget *parent, int x, int y, int w, int h);
 static void iconbar_set_method(Widget *widget);
@@ -75,14 +93,24 @@ static void iconbar_dtor(Iconbar *iconbar);
 static void iconbar_add_cbutton(Iconbar *iconbar, Window cwin);
 static void iconbar_del_cbutton(Iconbar *iconbar, Window cwin);
 static void iconbar_update(Iconbar *iconbar);
-static bool iconbar_has_similar_cbutton(Iconbar *iconbar, const Cbutton *cbutton);
+static int iconbar_get_view_w(const Iconbar *iconbar);
+static int iconbar_get_cbutton_w(const Iconbar *iconbar, const Cbutton *cbutton);
+static void iconbar_update_tip(const Iconbar *iconbar);
+static void iconbar_draw(const Iconbar *iconbar);
+static void iconbar_redraw_cbutton(const Iconbar *iconbar, const Cbutton *cbutton);
+static void iconbar_draw_cbutton(const Iconbar *iconbar, const Cbutton *cbutton);
+static void iconbar_redraw_more(const Iconbar *iconbar);
+static void iconbar_draw_more(const Iconbar *iconbar);
 static void iconbar_update_bg(const Widget *widget);
+static void iconbar_update_fg(const Widget *widget);
 static Statusbar *statusbar_new(Widget *parent, int x, int y, int w, int h, const char *label);
 static void statusbar_ctor(Statusbar *statusbar, Widget *parent, int x, int y, int w, int h, const char *label);
 static void statusbar_set_method(Widget *widget);
 static void statusbar_del(Statusbar *statusbar);
 static void statusbar_dtor(Statusbar *statusbar);
 static void statusbar_update_fg(const Widget *widget);
+static bool statusbar_update_rect(Statusbar *statusbar);
+static bool taskbar_defer_update(void);
 static Menu *act_center_new(void);
 
 static Taskbar *taskbar=NULL; // 每個WM自身只有一個任務欄
@@ -115,6 +143,7 @@ static void taskbar_ctor(Widget *parent, int x, int y, int w, int h)
     free(label);
 
     taskbar->act_center=act_center_new();
+    taskbar->frozen=taskbar->stale=false;
 }
 
 static Rect taskbar_compute_iconbar_rect(void)
@@ -197,6 +226,9 @@ void taskbar_update_bg(void)
 
 static void taskbar_buttons_update_bg(void)
 {
+    if(taskbar_defer_update())
+        return;
+
     for(int i=0; i<TASKBAR_BUTTON_N; i++)
         WIDGET_STATE(taskbar->buttons[i]).chosen=
             taskbar_button_is_chosen(TASKBAR_BUTTON_BEGIN+i);
@@ -236,64 +268,67 @@ void taskbar_remove_client(Window cwin)
     iconbar_del_cbutton(taskbar->iconbar, cwin);
 }
 
-static Cbutton *cbutton_new(Widget *parent, int x, int y, int w, int h, Window cwin)
+static Cbutton *cbutton_new(Window cwin)
 {
     Cbutton *cbutton=Malloc(sizeof(Cbutton));
-    cbutton_ctor(cbutton, parent, x, y, w, h, cwin);
+    XClassHint class_hint={NULL, NULL};
+    char *title=get_icon_title_text(cwin, "");
+
+    XGetClassHint(xinfo.display, cwin, &class_hint);
+    cbutton->cwin=cwin;
+    cbutton->title=NULL;
+    cbutton_set_title(cbutton, title);
+    cbutton->class_name=copy_string(class_hint.res_class);
+    cbutton->icon_name=copy_string(class_hint.res_name);
+    cbutton->image=get_win_icon_image(cwin);
+    cbutton->x=-1, cbutton->w=0;
+    vXFree(class_hint.res_name, class_hint.res_class);
+    free(title);
+
     return cbutton;
 }
 
 static void cbutton_del(Cbutton *cbutton)
 {
-    cbutton_dtor(cbutton);
+    Free(cbutton->title);
+    Free(cbutton->class_name);
+    Free(cbutton->icon_name);
     free(cbutton);
 }
 
-static void cbutton_ctor(Cbutton *cbutton, Widget *parent, int x, int y, int w, int h, Window cwin)
+static void cbutton_set_title(Cbutton *cbutton, const char *title)
 {
-    char *icon_title=get_icon_title_text(cwin, "");
-
-    cbutton->button=button_new(parent, CLIENT_ICON,
-        x, y, w, h, icon_title);
-    button_set_align(cbutton->button, CENTER_LEFT);
-
-    cbutton->cwin=cwin;
-
-    cbutton_set_icon(cbutton);
-    WIDGET_TOOLTIP(cbutton->button)=(Widget *)tooltip_new(WIDGET(cbutton->button), icon_title);
-    free(icon_title);
+    Free(cbutton->title);
+    cbutton->title=copy_string(title);
+    cbutton->label_w=0;
+    get_string_size(cbutton->title, &cbutton->label_w, NULL);
 }
 
-static void cbutton_dtor(Cbutton *cbutton)
+static bool is_same_class(const Cbutton *a, const Cbutton *b)
 {
-    button_del(WIDGET(cbutton->button));
-    cbutton->button=NULL;
+    return a->class_name && b->class_name && !strcmp(a->class_name, b->class_name);
 }
 
-static void cbutton_set_icon(Cbutton *cbutton)
+/* 滾輪用於滾動縮微窗口欄，故只對其他按鈕按橫坐標查找縮微窗口按鈕 */
+Window taskbar_get_client_win(const XButtonEvent *be)
 {
-    XClassHint class_hint={NULL, NULL};
-
-    XGetClassHint(xinfo.display, cbutton->cwin, &class_hint);
-    Imlib_Image image=get_win_icon_image(cbutton->cwin);
-
-    button_set_icon(cbutton->button, image, class_hint.res_name, NULL);
-    vXFree(class_hint.res_name, class_hint.res_class);
+    Cbutton *c = be->button<Button4 ?
+        iconbar_find_cbutton_by_x(taskbar->iconbar, be->x) : NULL;
+    return c ? c->cwin : None;
 }
 
-Window taskbar_get_client_win(const Window button_win)
+static Cbutton *iconbar_find_cbutton(const Iconbar *iconbar, Window cwin)
 {
-    for(unsigned int i=0; i<DESKTOP_N; i++)
-        LIST_FOR_EACH(Cbutton, cb, taskbar->iconbar->cbuttons)
-            if(WIDGET_WIN(cb->button) == button_win)
-                return cb->cwin;
-    return None;
+    LIST_FOR_EACH(Cbutton, p, iconbar->cbuttons)
+        if(p->cwin == cwin)
+            return p;
+    return NULL;
 }
 
-static Cbutton *iconbar_find_cbutton(const Iconbar *iconbar, Window cwin)
+static Cbutton *iconbar_find_cbutton_by_x(const Iconbar *iconbar, int x)
 {
     LIST_FOR_EACH(Cbutton, p, iconbar->cbuttons)
-        if(p->cwin == cwin)
+        if(p->x>=0 && x>=p->x && x<p->x+p->w)
             return p;
     return NULL;
 }
@@ -309,13 +344,22 @@ static Iconbar *iconbar_new(Widget *parent, int x, int y, int w, int h)
 static void iconbar_ctor(Iconbar *iconbar, Widget *parent, int x, int y, int w, int h)
 {
     widget_ctor(WIDGET(iconbar), parent, WIDGET_TYPE_ICONBAR, ICONBAR, x, y, w, h);
+    XSelectInput(xinfo.display, WIDGET_WIN(iconbar),
+        BUTTON_MASK|ExposureMask|CROSSING_MASK|PointerMotionMask);
+    set_tooltip(WIDGET(iconbar), "");
     iconbar->cbuttons=Malloc(sizeof(Cbutton));
     LIST_INIT(iconbar->cbuttons);
+    iconbar->hot=NULL;
+    iconbar->more_hot=false;
+    iconbar->first=iconbar->hidden_n=0;
+    iconbar->more_x=-1;
+    iconbar->buf=create_pixmap(WIDGET_WIN(iconbar), w, h, xinfo.depth, "iconbar");
 }
 
 static void iconbar_set_method(Widget *widget)
 {
     widget->update_bg=iconbar_update_bg;
+    widget->update_fg=iconbar_update_fg;
 }
 
 static void iconbar_del(Iconbar *iconbar)
@@ -329,72 +373,225 @@ static void iconbar_dtor(Iconbar *iconbar)
     LIST_FOR_EACH_SAFE(Cbutton, c, iconbar->cbuttons)
         cbutton_del(c);
     Free(iconbar->cbuttons);
+    free_pixmap(iconbar->buf);
 }
 
+/* 新按鈕排在同類窗口的按鈕之後，沒有同類窗口時排在最前 */
 static void iconbar_add_cbutton(Iconbar *iconbar, Window cwin)
 {
-    int h=WIDGET_H(iconbar), w=h;
-    Cbutton *c=cbutton_new(WIDGET(iconbar), 0, 0, w, h, cwin);
-    LIST_ADD(c, iconbar->cbuttons);
+    Cbutton *c=cbutton_new(cwin), *prev=iconbar->cbuttons;
+
+    LIST_FOR_EACH(Cbutton, p, iconbar->cbuttons)
+        if(is_same_class(p, c))
+            prev=p;
+    LIST_ADD(c, prev);
     iconbar_update(iconbar);
-    WIDGET(c->button)->show(WIDGET(c->button));
 }
 
 static void iconbar_del_cbutton(Iconbar *iconbar, Window cwin)
 {
-    LIST_FOR_EACH_SAFE(Cbutton, c, iconbar->cbuttons)
+    Cbutton *c=iconbar_find_cbutton(iconbar, cwin);
+    if(c == NULL)
+        return;
+
+    if(iconbar->hot == c)
+        iconbar->hot=NULL;
+    LIST_DEL(c);
+    cbutton_del(c);
+    iconbar_update(iconbar);
+}
+
+/* 從第first個按鈕開始依次排列，容納不下時在右端留出溢出指示區 */
+static void iconbar_update(Iconbar *iconbar)
+{
+    if(taskbar_defer_update())
+        return;
+
+    int i=0, x=0, sum=0, n=LIST_COUNT(iconbar->cbuttons), gap=cfg->icon_gap,
+        end=iconbar_get_view_w(iconbar), h=WIDGET_H(iconbar);
+
+    iconbar->first=MAX(0, MIN(iconbar->first, n-1));
+    LIST_FOR_EACH(Cbutton, c, iconbar->cbuttons)
     {
-        if(c->cwin == cwin)
-        {
-            LIST_DEL(c);
-            iconbar_update(iconbar);
-            cbutton_del(c);
+        c->x=-1, c->w=iconbar_get_cbutton_w(iconbar, c);
+        if(i++ >= iconbar->first)
+            sum += c->w+gap;
+    }
+
+    if(iconbar->first>0 || sum-gap>end)
+        iconbar->more_x=end-h, end -= h+gap;
+    else
+        iconbar->more_x=-1, iconbar->more_hot=false;
+
+    i=0, iconbar->hidden_n=n;
+    LIST_FOR_EACH(Cbutton, c, iconbar->cbuttons)
+    {
+        if(i++ < iconbar->first)
+            continue;
+        if(x+c->w > end)
             break;
-        }
+        c->x=x, x+=c->w+gap, iconbar->hidden_n--;
     }
+    iconbar_draw(iconbar);
 }
 
-static void iconbar_update(Iconbar *iconbar)
+/* 狀態欄疊放在縮微窗口欄的右端，被它遮擋的部分不可用 */
+static int iconbar_get_view_w(const Iconbar *iconbar)
 {
-    int x=0, w=0, h=WIDGET_H(iconbar), wi=h, wl=0, pad=get_font_pad();
+    int w=WIDGET_W(iconbar);
+    if(taskbar->statusbar)
+        w=MIN(w, WIDGET_X(taskbar->statusbar)-WIDGET_X(iconbar));
+    return MAX(w, 0);
+}
 
-    LIST_FOR_EACH(Cbutton, c, iconbar->cbuttons)
+/* 有同類窗口時，按鈕同時顯示圖標和標題，否則只顯示圖標 */
+static int iconbar_get_cbutton_w(const Iconbar *iconbar, const Cbutton *cbutton)
+{
+    const Cbutton *prev=LIST_PREV(Cbutton, cbutton),
+          *next=LIST_NEXT(Cbutton, cbutton);
+    int wi=WIDGET_H(iconbar);
+
+    if( (!LIST_IS_HEAD(prev, iconbar->cbuttons) && is_same_class(prev, cbutton))
+        || (!LIST_IS_HEAD(next, iconbar->cbuttons) && is_same_class(next, cbutton)))
+        return MIN(wi+cbutton->label_w+2*get_font_pad(), cfg->iconbar_width_max);
+    return wi;
+}
+
+void taskbar_scroll_iconbar(int n)
+{
+    Iconbar *iconbar=taskbar->iconbar;
+
+    if(iconbar->more_x < 0)
+        return;
+
+    if(n)
+        iconbar->first+=n;
+    else if(iconbar->hidden_n > iconbar->first) // 後面仍有未顯示的按鈕
+        iconbar->first+=MAX((int)LIST_COUNT(iconbar->cbuttons)-iconbar->hidden_n, 1);
+    else
+        iconbar->first=0;
+    iconbar->hot=NULL, iconbar->more_hot=false;
+    iconbar_update(iconbar);
+}
+
+bool taskbar_is_on_iconbar_more(int x)
+{
+    return taskbar->iconbar->more_x>=0 && x>=taskbar->iconbar->more_x;
+}
+
+void taskbar_point_iconbar(int x)
+{
+    Iconbar *iconbar=taskbar->iconbar;
+    const Cbutton *old=iconbar->hot;
+    bool old_more=iconbar->more_hot;
+
+    iconbar->more_hot=taskbar_is_on_iconbar_more(x);
+    iconbar->hot=iconbar_find_cbutton_by_x(iconbar, x);
+    if(old==iconbar->hot && old_more==iconbar->more_hot)
+        return;
+
+    iconbar_update_tip(iconbar);
+    if(taskbar_defer_update())
+        return;
+    if(old)
+        iconbar_redraw_cbutton(iconbar, old);
+    if(iconbar->hot)
+        iconbar_redraw_cbutton(iconbar, iconbar->hot);
+    if(old_more != iconbar->more_hot)
+        iconbar_redraw_more(iconbar);
+}
+
+static void iconbar_update_tip(const Iconbar *iconbar)
+{
+    Tooltip *tip=TOOLTIP(WIDGET_TOOLTIP(iconbar));
+
+    if(iconbar->more_hot)
     {
-        Button *b=c->button;
-        if(iconbar_has_similar_cbutton(iconbar, c))
-        {
-            get_string_size(button_get_label(b), &wl, NULL);
-            w=MIN(wi+wl+2*pad, cfg->iconbar_width_max);
-        }
-        else
-            w=wi;
-        widget_move_resize(WIDGET(b), x, WIDGET_Y(b), w, WIDGET_H(b)); 
-        x+=w+cfg->icon_gap;
+        char s[BUFSIZ];
+        snprintf(s, sizeof(s), _("另有%d個縮微窗口未顯示"), iconbar->hidden_n);
+        tooltip_change_tip(tip, s);
     }
+    else
+        tooltip_change_tip(tip, iconbar->hot ? iconbar->hot->title : "");
 }
 
-static bool iconbar_has_similar_cbutton(Iconbar *iconbar, const Cbutton *cbutton)
+static void iconbar_draw(const Iconbar *iconbar)
 {
-    bool result=false;
-    XClassHint ch={NULL, NULL}, ph;
+    if(taskbar_defer_update())
+        return;
 
-    if(!XGetClassHint(xinfo.display, cbutton->cwin, &ch))
-        return false;
+    GC gc=get_depth_gc(xinfo.depth);
+    int w=WIDGET_W(iconbar), h=WIDGET_H(iconbar);
 
-    LIST_FOR_EACH(Cbutton, p, iconbar->cbuttons)
+    XSetForeground(xinfo.display, gc, get_widget_color(NULL));
+    XFillRectangle(xinfo.display, iconbar->buf, gc, 0, 0, w, h);
+    LIST_FOR_EACH(Cbutton, c, iconbar->cbuttons)
+        if(c->x >= 0)
+            iconbar_draw_cbutton(iconbar, c);
+    if(iconbar->more_x >= 0)
+        iconbar_draw_more(iconbar);
+    XCopyArea(xinfo.display, iconbar->buf, WIDGET_WIN(iconbar), gc,
+        0, 0, w, h, 0, 0);
+}
+
+static void iconbar_redraw_cbutton(const Iconbar *iconbar, const Cbutton *cbutton)
+{
+    if(cbutton->x < 0)
+        return;
+
+    iconbar_draw_cbutton(iconbar, cbutton);
+    XCopyArea(xinfo.display, iconbar->buf, WIDGET_WIN(iconbar),
+        get_depth_gc(xinfo.depth), cbutton->x, 0, cbutton->w,
+        WIDGET_H(iconbar), cbutton->x, 0);
+}
+
+/* 定位器所指的按鈕按縮微窗口欄的狀態著色，其他按鈕按普通狀態著色 */
+static void iconbar_draw_cbutton(const Iconbar *iconbar, const Cbutton *cbutton)
+{
+    const Widget *state = cbutton==iconbar->hot ? WIDGET(iconbar) : NULL;
+    unsigned long bg=get_widget_color(state);
+    XftColor fg=get_text_color(state);
+    int x=cbutton->x, w=cbutton->w, h=WIDGET_H(iconbar), wi=h;
+    GC gc=get_depth_gc(xinfo.depth);
+
+    XSetForeground(xinfo.display, gc, bg);
+    XFillRectangle(xinfo.display, iconbar->buf, gc, x, 0, w, h);
+    if(cbutton->image)
+        render_image(cbutton->image, iconbar->buf, x, 0, wi, h);
+    else if(cbutton->icon_name)
     {
-        if(p!=cbutton && XGetClassHint(xinfo.display, p->cwin, &ph))
-        {
-            result=!strcmp(ph.res_class, ch.res_class);
-            vXFree(ph.res_class, ph.res_name);
-            if(result)
-                break;
-        }
+        char s[2]={cbutton->icon_name[0], '\0'};
+        Str_fmt fmt={x, 0, wi, h, CENTER, false, true, bg, fg};
+        draw_string(iconbar->buf, s, &fmt);
     }
+    if(w > wi)
+    {
+        Str_fmt fmt={x+wi, 0, w-wi, h, CENTER_LEFT, true, true, bg, fg};
+        draw_string(iconbar->buf, cbutton->title, &fmt);
+    }
+}
 
-    vXFree(ch.res_class, ch.res_name);
+static void iconbar_redraw_more(const Iconbar *iconbar)
+{
+    int x=iconbar->more_x, h=WIDGET_H(iconbar);
 
-    return result;
+    if(x < 0)
+        return;
+
+    iconbar_draw_more(iconbar);
+    XCopyArea(xinfo.display, iconbar->buf, WIDGET_WIN(iconbar),
+        get_depth_gc(xinfo.depth), x, 0, h, h, x, 0);
+}
+
+static void iconbar_draw_more(const Iconbar *iconbar)
+{
+    const Widget *state = iconbar->more_hot ? WIDGET(iconbar) : NULL;
+    int h=WIDGET_H(iconbar);
+    const char *symbol = iconbar->hidden_n>iconbar->first ? "»" : "«";
+    Str_fmt fmt={iconbar->more_x, 0, h, h, CENTER, false, true,
+        get_widget_color(state), get_text_color(state)};
+
+    draw_string(iconbar->buf, symbol, &fmt);
 }
 
 void taskbar_update_by_client_state(Window cwin)
@@ -418,7 +615,9 @@ void taskbar_update_by_icon_name(const Window cwin, const char *icon_name)
     if(cbutton == NULL)
         return;
 
-    button_set_label(cbutton->button, icon_name);
+    cbutton_set_title(cbutton, icon_name);
+    if(cbutton == taskbar->iconbar->hot)
+        iconbar_update_tip(taskbar->iconbar);
     iconbar_update(taskbar->iconbar);
 }
 
@@ -428,22 +627,25 @@ void taskbar_update_by_icon_image(const Window cwin, Imlib_Image image)
     if(cbutton == NULL)
         return;
 
-    button_change_icon(cbutton->button, image, NULL, NULL);
-    button_update_fg(WIDGET(cbutton->button));
+    if(!image || image==cbutton->image)
+        return;
+
+    free_image(cbutton->image);
+    cbutton->image=image;
+    if(!taskbar_defer_update())
+        iconbar_redraw_cbutton(taskbar->iconbar, cbutton);
 }
 
+/* 窗口背景始終保持普通狀態的顏色，按鈕的狀態由iconbar_draw_cbutton體現 */
 static void iconbar_update_bg(const Widget *widget)
 {
-    const Iconbar *iconbar=(const Iconbar *)widget;
-
-    widget_update_bg(WIDGET(iconbar));
-    /* Xlib手冊說窗口收到Expose事件時會更新背景，但事實上不知道爲何，上邊的語句
-     * 雖然給iconbar->win發送了Expose事件，但實際上沒更新背景。也許當窗口沒有內容
-     * 時，收到Expose事件並不會更新背景。故只好調用本函數強制更新背景。 */
-    XClearWindow(xinfo.display, WIDGET_WIN(taskbar->iconbar));
+    XSetWindowBackground(xinfo.display, WIDGET_WIN(widget), get_widget_color(NULL));
+    iconbar_draw((const Iconbar *)widget);
+}
 
-    LIST_FOR_EACH(Cbutton, cb, iconbar->cbuttons)
-        widget_update_bg(WIDGET(cb->button));
+static void iconbar_update_fg(const Widget *widget)
+{
+    iconbar_draw((const Iconbar *)widget);
 }
 
 static Statusbar *statusbar_new(Widget *parent, int x, int y, int w, int h, const char *label)
@@ -492,17 +694,57 @@ static void statusbar_update_fg(const Widget *widget)
 void taskbar_change_statusbar_label(const char *label)
 {
     Statusbar *s=taskbar->statusbar;
-    int x=WIDGET_X(s), y=WIDGET_Y(s), w=WIDGET_W(s), h=WIDGET_H(s), nw=0;
 
     Free(s->label);
     s->label=copy_string(label);
-    get_string_size(label, &nw, NULL);
+    if(taskbar_defer_update())
+        return;
+
+    if(statusbar_update_rect(s))
+        iconbar_update(taskbar->iconbar);
+    statusbar_update_fg(WIDGET(s));
+}
+
+/* 寬度改變時返回true */
+static bool statusbar_update_rect(Statusbar *statusbar)
+{
+    Statusbar *s=statusbar;
+    int x=WIDGET_X(s), y=WIDGET_Y(s), w=WIDGET_W(s), h=WIDGET_H(s), nw=0;
+
+    get_string_size(s->label, &nw, NULL);
     nw += 2*get_font_pad();
     if(nw > cfg->statusbar_width_max)
         nw=cfg->statusbar_width_max;
-    if(nw != w)
-        widget_move_resize(WIDGET(s), x+w-nw, y, nw, h);
-    statusbar_update_fg(WIDGET(s));
+    if(nw == w)
+        return false;
+    widget_move_resize(WIDGET(s), x+w-nw, y, nw, h);
+    return true;
+}
+
+/* 暫停更新時只記下有待更新，返回是否應推遲更新 */
+static bool taskbar_defer_update(void)
+{
+    if(taskbar->frozen)
+        taskbar->stale=true;
+    return taskbar->frozen;
+}
+
+/* 任務欄被全屏窗口完全遮擋時，重繪它只會佔用X服務器的時間，故暫停更新，待
+ * 恢復時再一次性補上暫停期間的變化 */
+void taskbar_set_frozen(bool frozen)
+{
+    if(taskbar->frozen == frozen)
+        return;
+
+    taskbar->frozen=frozen;
+    if(frozen || !taskbar->stale)
+        return;
+
+    taskbar->stale=false;
+    statusbar_update_rect(taskbar->statusbar);
+    iconbar_update(taskbar->iconbar);
+    taskbar_update_bg();
+    statusbar_update_fg(WIDGET(taskbar->statusbar));
 }
 
 static Menu *act_center_new(void)
@@ -26,11 +26,15 @@ void taskbar_set_urgency(const Client *c);
 void taskbar_set_attention(const Client *c);
 void taskbar_add_client(Window cwin);
 void taskbar_remove_client(Window cwin);
-Window taskbar_get_client_win(const Window button_win);
+Window taskbar_get_client_win(const XButtonEvent *be);
+void taskbar_scroll_iconbar(int n);
+bool taskbar_is_on_iconbar_more(int x);
+void taskbar_point_iconbar(int x);
 void taskbar_update_by_client_state(Window cwin);
 void taskbar_update_by_icon_name(const Window cwin, const char *icon_name);
 void taskbar_update_by_icon_image(const Window cwin, Imlib_Image image);
 void taskbar_change_statusbar_label(const char *label);
 void taskbar_show_act_center(void);
+void taskbar_set_frozen(bool frozen);
 
 #endif
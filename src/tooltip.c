@@ -72,10 +72,15 @@ void tooltip_change_tip(Tooltip *tooltip, const char *tip)
     Free(tooltip->tip);
     tooltip->tip=copy_string(tip);
 
-    int *pw=&WIDGET_W(tooltip), h=WIDGET_H(tooltip), pad=get_font_pad();
-    get_string_size(tip, pw, NULL);
-    *pw+=pad*2;
-    XResizeWindow(xinfo.display, WIDGET_WIN(tooltip), *pw, h);
+    int w=0, h=WIDGET_H(tooltip), pad=get_font_pad();
+    get_string_size(tip, &w, NULL);
+    w+=pad*2;
+    // 標題中的計數等變化通常不改變寬度，此時不必調整窗口尺寸
+    if(w != WIDGET_W(tooltip))
+    {
+        WIDGET_W(tooltip)=w;
+        XResizeWindow(xinfo.display, WIDGET_WIN(tooltip), w, h);
+    }
 }
 
 void tooltip_del(Widget *widget)
@@ -93,6 +98,9 @@ static void tooltip_dtor(Tooltip *tooltip)
 void tooltip_show(Widget *widget)
 {
     Tooltip *t=TOOLTIP(widget);
+    if(!t->tip || !t->tip[0]) // 如縮微窗口欄上未指向任何按鈕時
+        return;
+
     int *px=&WIDGET_X(t), *py=&WIDGET_Y(t), w=WIDGET_W(t), h=WIDGET_H(t);
     set_popup_pos(t->owner, true, px, py, w, h);
     XMoveWindow(xinfo.display, WIDGET_WIN(t), *px, *py);
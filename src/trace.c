@@ -0,0 +1,132 @@
+/* *************************************************************************
+ *     trace.c：實現以Chrome跟蹤格式記錄窗口管理器操作時間線的功能。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "config.h"
+#include "misc.h"
+#include "trace.h"
+
+/* 跟蹤記錄保存在環形緩衝區中，寫滿後覆蓋最舊的記錄。寫入者以原子加法領取各
+ * 自的槽位，無需加鎖。收到SIGUSR2信號或退出時，把記錄以Chrome跟蹤格式（JSON）
+ * 寫入cfg->trace_path，可用chrome://tracing或Perfetto打開 */
+#define TRACE_RING_SIZE (1<<16) // 環形緩衝區的記錄數，須爲2的冪
+
+typedef struct // 跟蹤記錄
+{
+    const char *name; // 操作名，須爲靜態字符串
+    uint64_t ts; // 時間戳，單位爲微秒
+    Window win; // 相關窗口
+    unsigned long serial; // 正在處理的事件的序號
+    char phase; // 'B'表示開始，'E'表示結束
+} Trace_record;
+
+bool trace_enabled=false;
+static Trace_record *records=NULL;
+static atomic_size_t head=0; // 下一條記錄的序號
+static unsigned long cur_serial=0; // 正在處理的事件的序號
+static volatile sig_atomic_t dump_requested=0;
+
+static void request_dump(int signum);
+static void write_trace_file(void);
+
+void init_trace(void)
+{
+    if(!cfg->trace_path)
+        return;
+
+    records=Malloc(TRACE_RING_SIZE*sizeof(Trace_record));
+    if(signal(SIGUSR2, request_dump) == SIG_ERR)
+        perror(_("不能安裝SIGUSR2信號處理函數"));
+    trace_enabled=true;
+}
+
+void deinit_trace(void)
+{
+    if(!trace_enabled)
+        return;
+
+    write_trace_file();
+    trace_enabled=false;
+    Free(records);
+}
+
+static void request_dump(int signum)
+{
+    UNUSED(signum);
+    dump_requested=1;
+}
+
+void set_trace_serial(unsigned long serial)
+{
+    cur_serial=serial;
+}
+
+void trace_span(const char *name, char phase, Window win)
+{
+    size_t i=atomic_fetch_add_explicit(&head, 1, memory_order_relaxed);
+
+    records[i&(TRACE_RING_SIZE-1)]=(Trace_record){name, get_monotonic_us(),
+        win, cur_serial, phase};
+}
+
+void handle_trace_request(void)
+{
+    if(!dump_requested)
+        return;
+    dump_requested=0;
+    write_trace_file();
+}
+
+static void write_trace_file(void)
+{
+    char name[FILENAME_MAX];
+    const char *path=cfg->trace_path, *home=getenv("HOME");
+
+    if(path[0]=='~' && !home)
+    {
+        fprintf(stderr, _("錯誤：未設置HOME環境變量，不能寫入跟蹤記錄文件！\n"));
+        return;
+    }
+    if(path[0] == '~')
+        snprintf(name, sizeof(name), "%s%s", home, path+1);
+    else
+        snprintf(name, sizeof(name), "%s", path);
+
+    FILE *fp=fopen(name, "w");
+    if(!fp)
+    {
+        perror(_("不能寫入跟蹤記錄文件"));
+        return;
+    }
+    dump_trace(fp);
+    fclose(fp);
+}
+
+/* 緩衝區被覆蓋後，最早的若干結束記錄可能缺少相應的開始記錄，查看器會忽略之 */
+void dump_trace(FILE *fp)
+{
+    size_t end=atomic_load(&head), n=MIN(end, (size_t)TRACE_RING_SIZE);
+    long pid=getpid();
+
+    fputs("{\"traceEvents\":[", fp);
+    for(size_t i=end-n; i<end; i++)
+    {
+        const Trace_record *r=records+(i&(TRACE_RING_SIZE-1));
+        fprintf(fp, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,"
+            "\"pid\":%ld,\"tid\":%ld,\"args\":{\"win\":\"0x%lx\",\"serial\":%lu}}",
+            i==end-n ? "" : ",", r->name, r->phase, (unsigned long long)r->ts,
+            pid, pid, r->win, r->serial);
+    }
+    fputs("\n],\"displayTimeUnit\":\"ms\"}\n", fp);
+}
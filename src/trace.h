@@ -0,0 +1,34 @@
+/* *************************************************************************
+ *     trace.h：與trace.c相應的頭文件。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <X11/Xlib.h>
+
+/* 未開啓跟蹤時，以下宏只需判斷一次trace_enabled */
+#define TRACE_BEGIN(name, win) \
+    do { if(trace_enabled) trace_span(name, 'B', win); } while(0)
+#define TRACE_END(name, win) \
+    do { if(trace_enabled) trace_span(name, 'E', win); } while(0)
+
+extern bool trace_enabled; // 是否正在跟蹤
+
+void init_trace(void);
+void deinit_trace(void);
+void set_trace_serial(unsigned long serial);
+void trace_span(const char *name, char phase, Window win);
+void handle_trace_request(void);
+void dump_trace(FILE *fp);
+
+#endif
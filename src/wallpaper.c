@@ -9,7 +9,23 @@
  * <http://www.gnu.org/licenses/>。
  * ************************************************************************/
 
+#define _GNU_SOURCE // 爲了使用pipe2
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 #include <time.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <setjmp.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <png.h>
+#include <X11/Xmd.h> // 須先於jpeglib.h包含，以免INT32重複定義
+#include <jpeglib.h>
 #include <Imlib2.h>
 #include "config.h"
 #include "color.h"
@@ -17,70 +33,570 @@
 #include "ewmh.h"
 #include "file.h"
 #include "misc.h"
+#include "trace.h"
+#include "xres.h"
 #include "wallpaper.h"
 
-static Pixmap create_pixmap_from_file(Window win, const char *filename);
+#define WALLPAPER_CACHE_MAGIC 0x67776d31 // "gwm1"
+
+/* 壁紙緩存文件的文件頭，其後緊接着w*h個已縮放至屏幕尺寸的ARGB像素 */
+typedef struct
+{
+    uint32_t magic;
+    int32_t w, h;
+    int64_t mtime; // 壁紙文件的修改時間
+} Wallpaper_cache_header;
+
+/* 解碼大圖片並縮放至屏幕尺寸很耗時，故由工作線程讀取緩存或解碼PNG、JPEG圖片，
+ * 得到已縮放的ARGB像素後經管道交回事件線程，事件線程只據此生成pixmap，因爲只
+ * 有事件線程纔能訪問X和Imlib2。工作線程不能解碼的其他格式仍由事件線程經
+ * Imlib2解碼。解碼任務分兩種：默認壁紙，以及預取的cur_wallpaper，後者同一時刻
+ * 至多只有一個 */
+typedef struct // 壁紙解碼任務
+{
+    char *filename, *cache; // 壁紙文件名、緩存文件名（可爲NULL）
+    time_t mtime; // 壁紙文件的修改時間
+    int w, h; // 目標尺寸
+    unsigned int depth; // 目標pixmap的色深
+    DATA32 *data; // 已縮放至w*h的ARGB像素，工作線程不能解碼時爲NULL
+    bool is_default; // 是否爲默認壁紙
+    unsigned int gen; // 創建任務時的bg_gen，僅用於默認壁紙
+} Wallpaper_job;
+
+typedef struct // libjpeg的錯誤處理器
+{
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} Jpeg_error;
+
+static void apply_default_wallpaper(Pixmap pixmap);
+static Wallpaper_job *new_wallpaper_job(const char *filename, bool is_default);
+static void free_wallpaper_job(Wallpaper_job *job);
+static bool start_wallpaper_job(void);
+static void run_wallpaper_job(Wallpaper_job *job);
+static void *decode_in_worker(void *arg);
+static void finish_wallpaper_job(Wallpaper_job *job);
+static void finish_prefetch(Pixmap pixmap);
+static Wallpaper_job *read_wallpaper_job(void);
+static void apply_wallpaper(Pixmap pixmap);
+static void decode_wallpaper(Wallpaper_job *job);
+static bool read_wallpaper_cache(Wallpaper_job *job);
+static DATA32 *decode_png(const char *filename, int w, int h);
+static DATA32 *decode_jpeg(const char *filename, int w, int h);
+static void handle_jpeg_error(j_common_ptr cinfo);
+static DATA32 *scale_argb(const DATA32 *src, int sw, int sh, int w, int h);
+static Pixmap create_pixmap_from_job(const Wallpaper_job *job);
+static void render_argb(const DATA32 *data, int w, int h);
+static void render_scaled_wallpaper(const char *filename, const char *cache, time_t mtime, int w, int h);
+static void save_wallpaper_cache(const char *cache, time_t mtime, int w, int h, const DATA32 *data);
+static void evict_wallpaper_cache(const char *cache);
+static bool is_wallpaper_cache(const char *name);
+static char *get_wallpaper_cache_name(const char *filename, int w, int h);
+static void free_next_pixmap(void);
 
 static Strings *wallpapers=NULL, *cur_wallpaper=NULL; // 壁紙文件列表、当前壁纸文件
+static Pixmap next_pixmap=None; // 預先爲cur_wallpaper生成的pixmap
+static bool need_prefetch=false; // 是否需要預取cur_wallpaper
+static bool prefetching=false; // 是否正在預取cur_wallpaper
+static bool switch_pending=false; // 是否待解碼完成後再切換壁紙
+static size_t npending=0; // 尚未交回的解碼任務數
+static unsigned int bg_gen=0; // 每次設置根窗口背景時遞增，用於丟棄過時的默認壁紙
+static int notify_fds[2]={-1, -1}; // 工作線程向事件線程交回任務的管道
 
 void init_wallpaper(void)
 {
+    if(pipe2(notify_fds, O_CLOEXEC))
+        perror(_("未能成功地創建壁紙通知管道"));
     if(cfg->wallpaper_paths == NULL)
         return;
 
     const char *paths=cfg->wallpaper_paths, *reg="*.png|*.jpg|*.svg|*.webp";
-    wallpapers=get_files_in_paths(paths, reg, true);
+    wallpapers=get_files_in_paths(paths, reg, true, cfg->wallpaper_search_depth);
     cur_wallpaper=LIST_FIRST(Strings, wallpapers);
+    need_prefetch=!LIST_IS_EMPTY(wallpapers);
 }
 
+int get_wallpaper_notify_fd(void)
+{
+    return notify_fds[0];
+}
+
+/* 在工作線程中解碼默認壁紙，完成後再設置 */
 void set_default_wallpaper(void)
 {
     const char *name=cfg->wallpaper_filename;
+    Wallpaper_job *job=new_wallpaper_job(name ? name : "", true);
+
+    if(job)
+        run_wallpaper_job(job);
+    else
+        apply_default_wallpaper(None);
+}
 
-    Pixmap pixmap=create_pixmap_from_file(xinfo.root_win, name ? name : "");
+static void apply_default_wallpaper(Pixmap pixmap)
+{
     update_win_bg(xinfo.root_win, get_root_color(), pixmap);
     if(pixmap && !have_compositor())
-        XFreePixmap(xinfo.display, pixmap);
+        free_pixmap(pixmap);
 }
 
-static Pixmap create_pixmap_from_file(Window win, const char *filename)
+/* 合成器啓停時切換根窗口背景的設置方式：有合成器時，背景pixmap須經由根窗口
+ * 特性提供給合成器，若還沒有則重設一次壁紙；沒有合成器時則釋放該pixmap */
+void update_wallpaper_mode(void)
+{
+    if(!have_compositor())
+        release_root_bg_pixmap();
+    else if(!get_root_bg_pixmap())
+        set_default_wallpaper();
+}
+
+static Wallpaper_job *new_wallpaper_job(const char *filename, bool is_default)
 {
     int w, h;
     unsigned int d;
-    Imlib_Image image=imlib_load_image(filename);
+    struct stat st;
 
-    if(!image || !get_geometry(win, NULL, NULL, &w, &h, NULL, &d))
-        return None;
+    if(stat(filename, &st) || !get_geometry(xinfo.root_win, NULL, NULL, &w, &h, NULL, &d))
+        return NULL;
 
-    Pixmap bg=XCreatePixmap(xinfo.display, win, w, h, d);
-    set_visual_for_imlib(win);
-    imlib_context_set_image(image);
-    imlib_context_set_drawable(bg);   
-    imlib_render_image_on_drawable_at_size(0, 0, w, h);
-    imlib_free_image();
-    return bg;
+    Wallpaper_job *job=Malloc(sizeof(Wallpaper_job));
+    *job=(Wallpaper_job){copy_string(filename), get_wallpaper_cache_name(filename, w, h),
+        st.st_mtime, w, h, d, NULL, is_default, is_default ? ++bg_gen : 0};
+    return job;
 }
 
+static void free_wallpaper_job(Wallpaper_job *job)
+{
+    if(job)
+        vfree(job->filename, job->cache, job->data, job);
+}
+
+/* 切換壁紙時優先使用預取的pixmap，否則待解碼完成後再切換 */
 void switch_to_next_wallpaper(void)
+{
+    if(!cfg->wallpaper_paths || LIST_IS_EMPTY(wallpapers))
+        apply_wallpaper(None);
+    else if(next_pixmap)
+    {
+        Pixmap pixmap=next_pixmap;
+        next_pixmap=None;
+        apply_wallpaper(pixmap);
+    }
+    else
+    {
+        switch_pending=true;
+        if(!prefetching)
+            start_wallpaper_job();
+    }
+}
+
+/* 由主事件循環在空閒時調用，以便在工作線程中預取下一張壁紙。若啓動了預取則
+ * 返回true，因爲其間可能已讀入了X事件 */
+bool prefetch_wallpaper(void)
+{
+    return need_prefetch && !prefetching && start_wallpaper_job();
+}
+
+/* 開始預取cur_wallpaper。返回是否訪問了X服務器 */
+static bool start_wallpaper_job(void)
+{
+    need_prefetch=false;
+    free_next_pixmap();
+
+    Wallpaper_job *job=new_wallpaper_job(cur_wallpaper->str, false);
+    if(job)
+        prefetching=true, run_wallpaper_job(job);
+    else
+        finish_prefetch(None);
+    return true;
+}
+
+/* 不能創建工作線程時，退而在事件線程中解碼 */
+static void run_wallpaper_job(Wallpaper_job *job)
+{
+    pthread_t tid;
+
+    if(notify_fds[1]>=0 && !pthread_create(&tid, NULL, decode_in_worker, job))
+        pthread_detach(tid), npending++;
+    else
+        decode_wallpaper(job), finish_wallpaper_job(job);
+}
+
+/* 工作線程：不得調用Xlib和Imlib2函數 */
+static void *decode_in_worker(void *arg)
+{
+    Wallpaper_job *job=arg;
+
+    decode_wallpaper(job);
+    while(write(notify_fds[1], &job, sizeof(job))<0 && errno==EINTR)
+        ;
+    return NULL;
+}
+
+/* 事件線程在壁紙通知管道可讀時調用 */
+void handle_wallpaper_notify(void)
+{
+    Wallpaper_job *job=read_wallpaper_job();
+
+    if(job)
+        npending--, finish_wallpaper_job(job);
+}
+
+/* 默認壁紙解碼期間若已切換過壁紙或再次設置了默認壁紙，則丟棄其結果 */
+static void finish_wallpaper_job(Wallpaper_job *job)
+{
+    TRACE_BEGIN("create_wallpaper_pixmap", xinfo.root_win);
+    Pixmap pixmap=create_pixmap_from_job(job);
+    TRACE_END("create_wallpaper_pixmap", xinfo.root_win);
+
+    bool is_default=job->is_default, stale=(job->gen != bg_gen);
+    free_wallpaper_job(job);
+    if(!is_default)
+        finish_prefetch(pixmap);
+    else if(!stale)
+        apply_default_wallpaper(pixmap);
+    else if(pixmap)
+        free_pixmap(pixmap);
+}
+
+static void finish_prefetch(Pixmap pixmap)
+{
+    prefetching=false;
+    if(switch_pending)
+        switch_pending=false, apply_wallpaper(pixmap);
+    else
+        next_pixmap=pixmap;
+}
+
+static Wallpaper_job *read_wallpaper_job(void)
+{
+    Wallpaper_job *job=NULL;
+    ssize_t n;
+
+    while((n=read(notify_fds[0], &job, sizeof(job)))<0 && errno==EINTR)
+        ;
+    return n==sizeof(job) ? job : NULL;
+}
+
+/* pixmap爲None時以隨機顏色作背景 */
+static void apply_wallpaper(Pixmap pixmap)
 {
     srand((unsigned int)time(NULL));
     unsigned long r1=rand(), r2=rand(), color=(r1<<16)|r2|0xff000000UL;
-    Pixmap pixmap=None;
 
-    if(cfg->wallpaper_paths)
+    TRACE_BEGIN("switch_to_next_wallpaper", xinfo.root_win);
+    bg_gen++;
+    if(cfg->wallpaper_paths && !LIST_IS_EMPTY(wallpapers))
     {
-        pixmap=create_pixmap_from_file(xinfo.root_win, cur_wallpaper->str);
         cur_wallpaper=LIST_NEXT(Strings, cur_wallpaper);
         if(LIST_IS_HEAD(cur_wallpaper, wallpapers))
             cur_wallpaper=LIST_NEXT(Strings, cur_wallpaper);
+        need_prefetch=true;
     }
 
     update_win_bg(xinfo.root_win, color, pixmap);
     if(pixmap && !have_compositor())
-        XFreePixmap(xinfo.display, pixmap);
+        free_pixmap(pixmap);
+    TRACE_END("switch_to_next_wallpaper", xinfo.root_win);
+}
+
+/* 優先使用緩存文件中已縮放好的像素，否則按文件頭的標志解碼PNG或JPEG圖片並縮
+ * 放，然後寫入緩存文件。可在工作線程中調用 */
+static void decode_wallpaper(Wallpaper_job *job)
+{
+    unsigned char magic[8]={0};
+    FILE *fp=NULL;
+
+    if(job->cache && read_wallpaper_cache(job))
+        return;
+    if(!(fp=fopen(job->filename, "rbe")))
+        return;
+    size_t n=fread(magic, 1, sizeof(magic), fp);
+    fclose(fp);
+
+    if(n==sizeof(magic) && !png_sig_cmp(magic, 0, sizeof(magic)))
+        job->data=decode_png(job->filename, job->w, job->h);
+    else if(n>=3 && magic[0]==0xff && magic[1]==0xd8 && magic[2]==0xff)
+        job->data=decode_jpeg(job->filename, job->w, job->h);
+    if(job->data && job->cache)
+        save_wallpaper_cache(job->cache, job->mtime, job->w, job->h, job->data);
+}
+
+static bool read_wallpaper_cache(Wallpaper_job *job)
+{
+    int fd=open(job->cache, O_RDONLY|O_CLOEXEC);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    size_t n=(size_t)job->w*job->h, size=sizeof(Wallpaper_cache_header)+n*sizeof(DATA32);
+    void *p=MAP_FAILED;
+    if(!fstat(fd, &st) && (size_t)st.st_size==size)
+        p=mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(p == MAP_FAILED)
+        return close(fd), false;
+
+    const Wallpaper_cache_header *hdr=p;
+    if( hdr->magic==WALLPAPER_CACHE_MAGIC && hdr->w==job->w && hdr->h==job->h
+        && hdr->mtime==(int64_t)job->mtime && (job->data=malloc(n*sizeof(DATA32))))
+        memcpy(job->data, hdr+1, n*sizeof(DATA32));
+    munmap(p, size);
+    // 以緩存文件的修改時間記錄最近使用時間，供evict_wallpaper_cache使用
+    if(job->data)
+        futimens(fd, NULL);
+    close(fd);
+    return job->data;
+}
+
+static DATA32 *decode_png(const char *filename, int w, int h)
+{
+    png_image image={.version=PNG_IMAGE_VERSION};
+    DATA32 *src=NULL, *dst=NULL;
+
+    if(!png_image_begin_read_from_file(&image, filename))
+        return NULL;
+    // DATA32在內存中的字節序取決於主機字節序
+    image.format = *(const char *)&(int){1} ? PNG_FORMAT_BGRA : PNG_FORMAT_ARGB;
+    if( (src=malloc(PNG_IMAGE_SIZE(image)))
+        && png_image_finish_read(&image, NULL, src, 0, NULL))
+        dst=scale_argb(src, image.width, image.height, w, h);
+    png_image_free(&image);
+    free(src);
+    return dst;
+}
+
+/* libjpeg可在解碼時把圖片縮小至1/2、1/4或1/8，故先取不小於目標尺寸的最大縮
+ * 小比例，以大幅減少大圖片的解碼時間 */
+static DATA32 *decode_jpeg(const char *filename, int w, int h)
+{
+    FILE *fp=fopen(filename, "rbe");
+    if(!fp)
+        return NULL;
+
+    struct jpeg_decompress_struct cinfo;
+    Jpeg_error jerr;
+    DATA32 *volatile src=NULL, *dst=NULL;
+
+    cinfo.err=jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit=handle_jpeg_error;
+    if(setjmp(jerr.jmp))
+    {
+        jpeg_destroy_decompress(&cinfo);
+        fclose(fp);
+        free(src);
+        return NULL;
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, fp);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space=JCS_RGB;
+    cinfo.scale_num=1, cinfo.scale_denom=1;
+    while( cinfo.scale_denom<8 && cinfo.image_width/(cinfo.scale_denom*2)>=(unsigned int)w
+        && cinfo.image_height/(cinfo.scale_denom*2)>=(unsigned int)h)
+        cinfo.scale_denom*=2;
+    jpeg_start_decompress(&cinfo);
+
+    int sw=cinfo.output_width, sh=cinfo.output_height;
+    JSAMPARRAY row=(*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, sw*3, 1);
+    if(!(src=malloc((size_t)sw*sh*sizeof(DATA32))))
+        longjmp(jerr.jmp, 1);
+    for(DATA32 *p=src; cinfo.output_scanline<cinfo.output_height; )
+    {
+        jpeg_read_scanlines(&cinfo, row, 1);
+        for(int x=0; x<sw; x++, p++)
+            *p=0xff000000|row[0][3*x]<<16|row[0][3*x+1]<<8|row[0][3*x+2];
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    fclose(fp);
+
+    dst=scale_argb(src, sw, sh, w, h);
+    free(src);
+    return dst;
+}
+
+/* 默認的錯誤處理器會退出程序，故改爲跳回decode_jpeg */
+static void handle_jpeg_error(j_common_ptr cinfo)
+{
+    Jpeg_error *err=(Jpeg_error *)cinfo->err;
+    (*cinfo->err->output_message)(cinfo);
+    longjmp(err->jmp, 1);
+}
+
+/* 把sw*sh的像素拉伸至w*h：縮小時取對應區域的平均值，放大時取最近的像素 */
+static DATA32 *scale_argb(const DATA32 *src, int sw, int sh, int w, int h)
+{
+    DATA32 *dst=malloc((size_t)w*h*sizeof(DATA32)), *p=dst;
+    if(!dst)
+        return NULL;
+
+    for(int y=0; y<h; y++)
+    {
+        int y0=(long long)y*sh/h, y1=MAX((long long)(y+1)*sh/h, y0+1);
+        for(int x=0; x<w; x++)
+        {
+            int x0=(long long)x*sw/w, x1=MAX((long long)(x+1)*sw/w, x0+1);
+            unsigned long a=0, r=0, g=0, b=0, n=(unsigned long)(x1-x0)*(y1-y0);
+            for(int j=y0; j<y1; j++)
+            {
+                for(const DATA32 *q=src+(size_t)j*sw+x0, *e=q+(x1-x0); q<e; q++)
+                    a+=*q>>24, r+=*q>>16&0xff, g+=*q>>8&0xff, b+=*q&0xff;
+            }
+            *p++=(DATA32)(a/n<<24|r/n<<16|g/n<<8|b/n);
+        }
+    }
+    return dst;
+}
+
+/* 只能在事件線程中調用 */
+static Pixmap create_pixmap_from_job(const Wallpaper_job *job)
+{
+    Pixmap bg=create_pixmap(xinfo.root_win, job->w, job->h, job->depth, "wallpaper");
+
+    set_visual_for_imlib(xinfo.root_win);
+    imlib_context_set_drawable(bg);
+    if(job->data)
+        render_argb(job->data, job->w, job->h);
+    else
+        render_scaled_wallpaper(job->filename, job->cache, job->mtime, job->w, job->h);
+    return bg;
+}
+
+static void render_argb(const DATA32 *data, int w, int h)
+{
+    Imlib_Image image=imlib_create_image_using_data(w, h, (DATA32 *)data);
+    if(!image)
+        return;
+
+    imlib_context_set_image(image);
+    imlib_render_image_on_drawable(0, 0);
+    imlib_free_image();
+}
+
+/* 以Imlib2解碼工作線程不支持的格式 */
+static void render_scaled_wallpaper(const char *filename, const char *cache, time_t mtime, int w, int h)
+{
+    Imlib_Image image=imlib_load_image(filename), scaled=NULL;
+    if(!image)
+        return;
+
+    imlib_context_set_image(image);
+    scaled=imlib_create_cropped_scaled_image(0, 0, imlib_image_get_width(),
+        imlib_image_get_height(), w, h);
+    imlib_free_image();
+    if(!scaled)
+        return;
+
+    imlib_context_set_image(scaled);
+    imlib_render_image_on_drawable(0, 0);
+    if(cache)
+        save_wallpaper_cache(cache, mtime, w, h, imlib_image_get_data_for_reading_only());
+    imlib_free_image();
+}
+
+/* 先寫入臨時文件再改名，以免其他gwm實例讀到不完整的緩存 */
+static void save_wallpaper_cache(const char *cache, time_t mtime, int w, int h, const DATA32 *data)
+{
+    Wallpaper_cache_header hdr={WALLPAPER_CACHE_MAGIC, w, h, mtime};
+    char *tmp=copy_strings(cache, ".tmp", NULL);
+    FILE *fp=fopen(tmp, "we");
+
+    if(fp)
+    {
+        bool ok = fwrite(&hdr, sizeof(hdr), 1, fp)==1
+            && fwrite(data, sizeof(DATA32), (size_t)w*h, fp)==(size_t)w*h;
+        if(fclose(fp)==0 && ok && rename(tmp, cache)==0)
+            evict_wallpaper_cache(cache);
+        else
+            remove(tmp);
+    }
+    Free(tmp);
+}
+
+/* 緩存文件數超過上限時，逐個刪除修改時間最早即最久未用的緩存文件。可在工作
+ * 線程中調用 */
+static void evict_wallpaper_cache(const char *cache)
+{
+    char *dir=copy_string(cache), *oldest=NULL;
+    int n, dfd;
+    DIR *dp=NULL;
+
+    *strrchr(dir, '/')='\0';
+    if((dfd=open(dir, O_RDONLY|O_DIRECTORY|O_CLOEXEC))<0 || !(dp=fdopendir(dfd)))
+    {
+        if(dfd >= 0)
+            close(dfd);
+        Free(dir);
+        return;
+    }
+
+    do
+    {
+        struct dirent *de=NULL;
+        struct stat st;
+        time_t min=0;
+
+        n=0, Free(oldest);
+        rewinddir(dp);
+        while((de=readdir(dp)))
+        {
+            if(!is_wallpaper_cache(de->d_name) || fstatat(dfd, de->d_name, &st, 0))
+                continue;
+            if(n++==0 || st.st_mtime<min)
+                min=st.st_mtime, Free(oldest), oldest=copy_string(de->d_name);
+        }
+    } while(n>MAX(cfg->wallpaper_cache_max, 1) && oldest && !unlinkat(dfd, oldest, 0));
+
+    Free(oldest);
+    closedir(dp);
+    Free(dir);
+}
+
+static bool is_wallpaper_cache(const char *name)
+{
+    const char *prefix="wallpaper-", *suffix=".raw";
+    size_t n=strlen(name), np=strlen(prefix), ns=strlen(suffix);
+    return n>np+ns && !strncmp(name, prefix, np) && !strcmp(name+n-ns, suffix);
+}
+
+/* 緩存文件名由壁紙文件路徑的FNV-1a散列值和屏幕尺寸組成，修改時間則記錄在文件頭中 */
+static char *get_wallpaper_cache_name(const char *filename, int w, int h)
+{
+    const char *dir=cfg->wallpaper_cache_path, *home=getenv("HOME");
+    char name[FILENAME_MAX];
+    uint64_t hash=get_string_hash(filename);
+
+    // 未設置HOME時無法展開~，故不使用緩存
+    if(!dir || (dir[0]=='~' && !home))
+        return NULL;
+    if(dir[0] == '~')
+        snprintf(name, sizeof(name), "%s%s", home, dir+1);
+    else
+        snprintf(name, sizeof(name), "%s", dir);
+    if(!make_dirs(name))
+        return NULL;
+    snprintf(name+strlen(name), sizeof(name)-strlen(name),
+        "/wallpaper-%016llx-%dx%d.raw", (unsigned long long)hash, w, h);
+    return copy_string(name);
+}
+
+static void free_next_pixmap(void)
+{
+    if(next_pixmap)
+        free_pixmap(next_pixmap), next_pixmap=None;
 }
 
+/* 等待尚未完成的解碼任務，以免工作線程在退出後訪問已釋放的資源 */
 void free_wallpapers(void)
 {
-    vfree_strings(wallpapers);
+    for(Wallpaper_job *job=NULL; npending && (job=read_wallpaper_job()); npending--)
+        free_wallpaper_job(job);
+    prefetching=switch_pending=false;
+    for(size_t i=0; i<ARRAY_NUM(notify_fds); i++)
+        if(notify_fds[i] >= 0)
+            close(notify_fds[i]), notify_fds[i]=-1;
+    free_next_pixmap();
+    if(wallpapers)
+        vfree_strings(wallpapers);
 }
@@ -12,8 +12,14 @@
 #ifndef WALLPAPER_H
 #define WALLPAPER_H
 
+#include <stdbool.h>
+
+int get_wallpaper_notify_fd(void);
 void set_default_wallpaper(void);
+void update_wallpaper_mode(void);
 void switch_to_next_wallpaper(void);
+bool prefetch_wallpaper(void);
+void handle_wallpaper_notify(void);
 void init_wallpaper(void);
 void free_wallpapers(void);
 
@@ -16,6 +16,7 @@
 #include "list.h"
 #include "drawable.h"
 #include "grab.h"
+#include "xres.h"
 #include "widget.h"
 
 #define WIDGET_STATE_NORMAL ((Widget_state){0})
@@ -138,7 +139,7 @@ void widget_del(Widget *widget)
 static void widget_dtor(Widget *widget)
 {
     if(widget->type != WIDGET_TYPE_CLIENT)
-        XDestroyWindow(xinfo.display, widget->win);
+        destroy_win(widget->win);
     widget_unreg(widget);
 }
 
@@ -253,6 +254,7 @@ Window create_widget_win(Window parent, int x, int y, int w, int h, int border_w
     Window win=XCreateWindow(xinfo.display, parent, x, y, w, h, border_w, xinfo.depth,
         InputOutput, xinfo.visual,
         CWColormap | CWBorderPixel | CWBackPixel | CWOverrideRedirect, &attr);
+    reg_xres(XRES_WINDOW, win, "widget", 0);
 
     return win;
 }
@@ -311,11 +313,9 @@ KeySym look_up_key(XIC xic, XKeyEvent *e, wchar_t *keyname, size_t n)
     return ks;
 }
 
-bool is_valid_click(const Widget *widget, const Buttonbind *bind, XButtonEvent *be)
+/* id爲被單擊的構件標識，縮微窗口欄上的按鈕與縮微窗口欄本身的標識不同 */
+bool is_valid_click(const Widget *widget, Widget_id id, const Buttonbind *bind, XButtonEvent *be)
 {
-    Widget_id id = widget ? widget->id :
-        (be->window==xinfo.root_win ? ROOT_WIN : UNUSED_WIDGET_ID);
-
     if(!is_func_click(id, bind, be))
         return false;
 
@@ -112,7 +112,7 @@ Window create_widget_win(Window parent, int x, int y, int w, int h, int border_w
 void set_popup_pos(const Widget *widget, bool near_pointer, int *px, int *py, int pw, int ph);
 void set_xic(Window win, XIC *ic);
 KeySym look_up_key(XIC xic, XKeyEvent *e, wchar_t *keyname, size_t n);
-bool is_valid_click(const Widget *widget, const Buttonbind *bind, XButtonEvent *be);
+bool is_valid_click(const Widget *widget, Widget_id id, const Buttonbind *bind, XButtonEvent *be);
 unsigned long get_widget_color(const Widget *widget);
 XftColor get_text_color(const Widget *widget);
 
@@ -11,6 +11,7 @@
 
 #include "misc.h"
 #include "prop.h"
+#include "layout.h"
 #include "clientop.h"
 #include "focus.h"
 #include "taskbar.h"
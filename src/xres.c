@@ -0,0 +1,267 @@
+/* *************************************************************************
+ *     xres.c：實現X資源的登記及泄漏檢測功能。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include <string.h>
+#include "gwm.h"
+#include "misc.h"
+#include "xres.h"
+
+/* 以開放定址的散列表登記本程序創建的X資源及Imlib映像，並標明其所屬的子系統，
+ * 以便統計存量並檢測長時間運行後的泄漏。刪除表項時把其後同一探測鏈上的表項前
+ * 移，故無需墓碑標記 */
+#define XRES_TABLE_SIZE_MIN 64 // 散列表的最小容量，須爲2的冪
+#define DEPTH_MAX 32 // 深度的最大值
+
+typedef struct // 已登記的資源
+{
+    uintptr_t id; // 資源標識，0表示空表項
+    Xres_type type;
+    const char *owner; // 所屬子系統，須爲靜態字符串
+    size_t bytes; // 估計的內存佔用量
+} Xres;
+
+static Xres *xres_table=NULL;
+static size_t xres_table_size=0, xres_n=0; // 表的容量、已登記的資源數
+static Xres_usage xres_usage;
+static GC depth_gcs[DEPTH_MAX+1]={NULL}; // 按深度緩存的圖形上下文
+
+static size_t get_xres_hash(Xres_type type, uintptr_t id);
+static Xres *find_xres(Xres_type type, uintptr_t id);
+static void grow_xres_table(void);
+static void insert_xres(const Xres *res);
+static void del_xres(Xres *res);
+static size_t get_pixmap_bytes(int w, int h, int depth);
+
+static size_t get_xres_hash(Xres_type type, uintptr_t id)
+{
+    uint64_t h=((uint64_t)id^type)*0x9e3779b97f4a7c15ULL;
+    return (h>>32) & (xres_table_size-1);
+}
+
+static Xres *find_xres(Xres_type type, uintptr_t id)
+{
+    if(!xres_table_size || !id)
+        return NULL;
+
+    for(size_t i=get_xres_hash(type, id); xres_table[i].id; i=(i+1)&(xres_table_size-1))
+        if(xres_table[i].id==id && xres_table[i].type==type)
+            return xres_table+i;
+    return NULL;
+}
+
+void reg_xres(Xres_type type, uintptr_t id, const char *owner, size_t bytes)
+{
+    if(!id || find_xres(type, id))
+        return;
+
+    if((xres_n+1)*2 > xres_table_size)
+        grow_xres_table();
+    insert_xres(&(Xres){id, type, owner, bytes});
+    xres_n++;
+    xres_usage.count[type]++;
+    xres_usage.bytes[type] += bytes;
+}
+
+static void grow_xres_table(void)
+{
+    Xres *old=xres_table;
+    size_t old_size=xres_table_size;
+
+    xres_table_size = old_size ? old_size*2 : XRES_TABLE_SIZE_MIN;
+    xres_table=Malloc(xres_table_size*sizeof(Xres));
+    memset(xres_table, 0, xres_table_size*sizeof(Xres));
+    for(size_t i=0; i<old_size; i++)
+        if(old[i].id)
+            insert_xres(old+i);
+    Free(old);
+}
+
+static void insert_xres(const Xres *res)
+{
+    size_t i=get_xres_hash(res->type, res->id);
+    while(xres_table[i].id)
+        i=(i+1)&(xres_table_size-1);
+    xres_table[i]=*res;
+}
+
+void unreg_xres(Xres_type type, uintptr_t id)
+{
+    Xres *res=find_xres(type, id);
+    if(!res)
+        return;
+
+    xres_n--;
+    xres_usage.count[type]--;
+    xres_usage.bytes[type] -= res->bytes;
+    del_xres(res);
+}
+
+/* 把空位之後、探測起點不在空位與其之間的表項前移至空位 */
+static void del_xres(Xres *res)
+{
+    size_t mask=xres_table_size-1, i=res-xres_table, j=i;
+
+    xres_table[i].id=0;
+    while(xres_table[j=(j+1)&mask].id)
+    {
+        size_t k=get_xres_hash(xres_table[j].type, xres_table[j].id);
+        if(((j-k)&mask) >= ((j-i)&mask))
+            xres_table[i]=xres_table[j], xres_table[j].id=0, i=j;
+    }
+}
+
+bool is_xres_registered(Xres_type type, uintptr_t id)
+{
+    return find_xres(type, id);
+}
+
+void get_xres_usage(Xres_usage *usage)
+{
+    *usage=xres_usage;
+}
+
+/* 判斷自base以來是否有任何一類資源的數量或內存佔用量增長了 */
+bool is_xres_grown(const Xres_usage *base)
+{
+    for(int i=0; i<XRES_TYPE_N; i++)
+        if( xres_usage.count[i]>base->count[i]
+            || xres_usage.bytes[i]>base->bytes[i])
+            return true;
+    return false;
+}
+
+void dump_xres(FILE *fp)
+{
+    static const char *names[XRES_TYPE_N]={[XRES_WINDOW]="window",
+        [XRES_PIXMAP]="pixmap", [XRES_GC]="gc", [XRES_CURSOR]="cursor",
+        [XRES_XFT_DRAW]="xftdraw", [XRES_IMAGE]="image"};
+
+    fprintf(fp, _("以下是X資源存量：\n"));
+    fprintf(fp, "%-12s %-10s %8s %12s\n", "owner", "type", "count", "bytes");
+    for(size_t i=0; i<xres_table_size; i++)
+    {
+        const Xres *r=xres_table+i;
+        bool dumped=false;
+
+        if(!r->id) // 同一子系統的同類資源只在首次出現時匯總輸出
+            continue;
+        for(size_t j=0; j<i && !dumped; j++)
+            dumped = xres_table[j].id && xres_table[j].type==r->type
+                && strcmp(xres_table[j].owner, r->owner)==0;
+        if(dumped)
+            continue;
+
+        size_t n=0, bytes=0;
+        for(size_t j=i; j<xres_table_size; j++)
+            if( xres_table[j].id && xres_table[j].type==r->type
+                && strcmp(xres_table[j].owner, r->owner)==0)
+                n++, bytes+=xres_table[j].bytes;
+        fprintf(fp, "%-12s %-10s %8zu %12zu\n", r->owner, names[r->type], n, bytes);
+    }
+    for(int i=0; i<XRES_TYPE_N; i++)
+        fprintf(fp, "%-12s %-10s %8zu %12zu\n", "total", names[i],
+            xres_usage.count[i], xres_usage.bytes[i]);
+    fflush(fp);
+}
+
+void free_xres_table(void)
+{
+    Free(xres_table);
+    xres_table_size=xres_n=0;
+    memset(&xres_usage, 0, sizeof(xres_usage));
+}
+
+Pixmap create_pixmap(Drawable d, int w, int h, int depth, const char *owner)
+{
+    Pixmap pixmap=XCreatePixmap(xinfo.display, d, w, h, depth);
+    reg_xres(XRES_PIXMAP, pixmap, owner, get_pixmap_bytes(w, h, depth));
+    return pixmap;
+}
+
+/* 服務器通常以1、2、4字節存儲不超過8、16、32位的像素 */
+static size_t get_pixmap_bytes(int w, int h, int depth)
+{
+    size_t bpp = depth>16 ? 4 : (depth>8 ? 2 : 1);
+    return (size_t)w*h*bpp;
+}
+
+void free_pixmap(Pixmap pixmap)
+{
+    unreg_xres(XRES_PIXMAP, pixmap);
+    XFreePixmap(xinfo.display, pixmap);
+}
+
+GC create_gc(Drawable d, unsigned long mask, XGCValues *values, const char *owner)
+{
+    GC gc=XCreateGC(xinfo.display, d, mask, values);
+    reg_xres(XRES_GC, (uintptr_t)gc, owner, 0);
+    return gc;
+}
+
+void free_gc(GC gc)
+{
+    unreg_xres(XRES_GC, (uintptr_t)gc);
+    XFreeGC(xinfo.display, gc);
+}
+
+/* 返回可用於指定深度的可繪物的圖形上下文。它們由各處共用，故使用者須自行設
+ * 置所需的屬性，且用後不應釋放 */
+GC get_depth_gc(int depth)
+{
+    if(depth<=0 || depth>DEPTH_MAX)
+        depth=xinfo.depth;
+    if(!depth_gcs[depth])
+    {
+        Pixmap pixmap=XCreatePixmap(xinfo.display, xinfo.root_win, 1, 1, depth);
+        depth_gcs[depth]=create_gc(pixmap, 0, NULL, "gc_cache");
+        XFreePixmap(xinfo.display, pixmap);
+    }
+    return depth_gcs[depth];
+}
+
+void free_depth_gcs(void)
+{
+    for(size_t i=0; i<ARRAY_NUM(depth_gcs); i++)
+        if(depth_gcs[i])
+            free_gc(depth_gcs[i]), depth_gcs[i]=NULL;
+}
+
+XftDraw *create_xft_draw(Drawable d, const char *owner)
+{
+    XftDraw *draw=XftDrawCreate(xinfo.display, d, xinfo.visual, xinfo.colormap);
+    reg_xres(XRES_XFT_DRAW, (uintptr_t)draw, owner, 0);
+    return draw;
+}
+
+void destroy_xft_draw(XftDraw *draw)
+{
+    unreg_xres(XRES_XFT_DRAW, (uintptr_t)draw);
+    XftDrawDestroy(draw);
+}
+
+Cursor create_font_cursor(unsigned int shape, const char *owner)
+{
+    Cursor cursor=XCreateFontCursor(xinfo.display, shape);
+    reg_xres(XRES_CURSOR, cursor, owner, 0);
+    return cursor;
+}
+
+void free_cursor(Cursor cursor)
+{
+    unreg_xres(XRES_CURSOR, cursor);
+    XFreeCursor(xinfo.display, cursor);
+}
+
+void destroy_win(Window win)
+{
+    unreg_xres(XRES_WINDOW, win);
+    XDestroyWindow(xinfo.display, win);
+}
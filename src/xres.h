@@ -0,0 +1,52 @@
+/* *************************************************************************
+ *     xres.h：與xres.c相應的頭文件。
+ *     版權 (C) 2020-2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#ifndef XRES_H
+#define XRES_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <X11/Xlib.h>
+#include <X11/Xft/Xft.h>
+
+typedef enum // 資源類型
+{
+    XRES_WINDOW, XRES_PIXMAP, XRES_GC, XRES_CURSOR, XRES_XFT_DRAW, XRES_IMAGE,
+    XRES_TYPE_N
+} Xres_type;
+
+typedef struct // 各類資源的存量
+{
+    size_t count[XRES_TYPE_N]; // 資源數
+    size_t bytes[XRES_TYPE_N]; // 估計的內存佔用量
+} Xres_usage;
+
+void reg_xres(Xres_type type, uintptr_t id, const char *owner, size_t bytes);
+void unreg_xres(Xres_type type, uintptr_t id);
+bool is_xres_registered(Xres_type type, uintptr_t id);
+void get_xres_usage(Xres_usage *usage);
+bool is_xres_grown(const Xres_usage *base);
+void dump_xres(FILE *fp);
+void free_xres_table(void);
+Pixmap create_pixmap(Drawable d, int w, int h, int depth, const char *owner);
+void free_pixmap(Pixmap pixmap);
+GC create_gc(Drawable d, unsigned long mask, XGCValues *values, const char *owner);
+void free_gc(GC gc);
+GC get_depth_gc(int depth);
+void free_depth_gcs(void);
+XftDraw *create_xft_draw(Drawable d, const char *owner);
+void destroy_xft_draw(XftDraw *draw);
+Cursor create_font_cursor(unsigned int shape, const char *owner);
+void free_cursor(Cursor cursor);
+void destroy_win(Window win);
+
+#endif
@@ -0,0 +1,38 @@
+/* *************************************************************************
+ *     bcolor.c：對color模塊進行微基準測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L // 爲了使用clock_gettime
+
+#include "../../src/color.c"
+#include "bench.h"
+
+static void bench_rgb_hsb(void);
+
+int main(void)
+{
+    bench_rgb_hsb();
+
+    return 0;
+}
+
+static void bench_rgb_hsb(void)
+{
+    RGB rgb={0};
+    HSB hsb={0};
+    size_t n=0;
+
+    BENCH("rgb_to_hsb", 1000000,
+        n++; hsb=rgb_to_hsb((RGB){n&0xff, (n>>8)&0xff, (n>>16)&0xff});
+        bench_sink+=(uintptr_t)hsb.h);
+    BENCH("hsb_to_rgb", 1000000,
+        n++; rgb=hsb_to_rgb(HSB(n%360, (n%101)/100.0, (n%97)/96.0));
+        bench_sink+=rgb.r);
+}
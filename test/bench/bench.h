@@ -0,0 +1,44 @@
+/* *************************************************************************
+ *     bench.h：微基準測試程序的公共輔助函數。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/* 以iters次重復執行stmt，並以JSON格式輸出平均每次的耗時。每個結果佔一行，
+ * 由make bench匯總成JSON數組 */
+#define BENCH(name, iters, stmt)                                \
+    do {                                                        \
+        uint64_t bench_start=bench_now_ns();                    \
+        for(size_t bench_i=0; bench_i<(size_t)(iters); bench_i++) \
+            { stmt; }                                           \
+        bench_report(name, iters, bench_now_ns()-bench_start);  \
+    } while(0)
+
+static volatile uintptr_t bench_sink; // 防止編譯器把被測代碼優化掉
+
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec*1000000000+t.tv_nsec;
+}
+
+static inline void bench_report(const char *name, size_t iters, uint64_t ns)
+{
+    printf("{\"name\":\"%s\",\"iterations\":%zu,\"ns_per_op\":%.2f}\n",
+        name, iters, (double)ns/iters);
+}
+
+#endif
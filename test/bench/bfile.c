@@ -0,0 +1,82 @@
+/* *************************************************************************
+ *     bfile.c：對file模塊進行微基準測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include "../../src/file.c"
+#include "bench.h"
+
+#define DIR_N 20
+#define FILE_N 100
+
+static void bench_match_pattern(void);
+static void bench_get_files_in_paths(void);
+static char *create_tree(void);
+
+int main(void)
+{
+    bench_match_pattern();
+    bench_get_files_in_paths();
+
+    return 0;
+}
+
+static void bench_match_pattern(void)
+{
+    Pattern *p=compile_pattern("*.png|*.jpg|*.svg|*.webp");
+    BENCH("match_pattern_suffix_alts", 1000000,
+        bench_sink+=match_pattern(p, "a-fairly-long-wallpaper-name.webp"));
+    free_pattern(p);
+
+    p=compile_pattern("*fedora*.*png|gwm*");
+    BENCH("match_pattern_glob", 1000000,
+        bench_sink+=match_pattern(p, "f38-01-fedora-day-wallpaper.png"));
+    free_pattern(p);
+
+    BENCH("compile_match_free_pattern", 100000,
+        p=compile_pattern("*.png|*.jpg");
+        bench_sink+=match_pattern(p, "wallpaper.png");
+        free_pattern(p));
+}
+
+static void bench_get_files_in_paths(void)
+{
+    char *dir=create_tree(), *cmd=copy_strings("rm -rf ", dir, NULL);
+
+    BENCH("get_files_in_paths_2000_files", 100,
+        Strings *files=get_files_in_paths(dir, "*.png", false, -1);
+        bench_sink+=(uintptr_t)files;
+        vfree_strings(files);
+        Free(files));
+    if(system(cmd) != 0)
+        perror(cmd);
+    vfree(dir, cmd);
+}
+
+/* 生成DIR_N個子目錄，每個子目錄中有FILE_N個文件，半數爲png */
+static char *create_tree(void)
+{
+    char d[]="/tmp/bfileXXXXXX", name[FILENAME_MAX];
+
+    if(!mkdtemp(d))
+        exit_with_perror("mkdtemp");
+    for(int i=0; i<DIR_N; i++)
+    {
+        snprintf(name, sizeof(name), "%s/dir%d", d, i);
+        mkdir(name, 0700);
+        for(int j=0; j<FILE_N; j++)
+        {
+            snprintf(name, sizeof(name), "%s/dir%d/file%d.%s", d, i, j, j%2 ? "png" : "txt");
+            FILE *fp=fopen(name, "w");
+            if(fp)
+                fclose(fp);
+        }
+    }
+    return copy_string(d);
+}
@@ -0,0 +1,61 @@
+/* *************************************************************************
+ *     bfont.c：對font模塊進行微基準測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L // 爲了使用clock_gettime
+
+#include "../../src/font.c"
+#include "bench.h"
+
+/* 混合了拉丁字母、漢字、符號和表情的窗口標題 */
+#define MIXED_TITLE "gwm - 窗口管理器 README.md ✓ 🙂 — Vim ☰ 終端 αβγ"
+
+static void bench_get_utf8_codepoint(void);
+static void bench_get_string_size(void);
+
+int main(void)
+{
+    bench_get_utf8_codepoint();
+    bench_get_string_size();
+
+    return 0;
+}
+
+static void bench_get_utf8_codepoint(void)
+{
+    uint32_t codepoint;
+
+    BENCH("get_utf8_codepoint_mixed_title", 1000000,
+        for(const char *s=MIXED_TITLE; *s;)
+        {
+            int len=get_utf8_codepoint(s, &codepoint);
+            bench_sink+=codepoint;
+            s += len ? len : 1;
+        });
+}
+
+/* 需要X服務器，無法連接時不輸出此項結果 */
+static void bench_get_string_size(void)
+{
+    if(!(xinfo.display=XOpenDisplay(NULL)))
+        return;
+
+    int w, h;
+    xinfo.screen=DefaultScreen(xinfo.display);
+    cfg=Malloc(sizeof(Config));
+    cfg->font_size=16;
+    cfg->font_names=(const char *[]){"monospace", "Noto Color Emoji", NULL};
+    load_fonts();
+    BENCH("get_string_size_mixed_title", 10000,
+        get_string_size(MIXED_TITLE, &w, &h); bench_sink+=w);
+    close_fonts();
+    Free(cfg);
+    XCloseDisplay(xinfo.display);
+}
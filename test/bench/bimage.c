@@ -0,0 +1,105 @@
+/* *************************************************************************
+ *     bimage.c：對image模塊進行微基準測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L // 爲了使用clock_gettime和mkdtemp
+
+#include <sys/stat.h>
+#include "../../src/image.c"
+#include "bench.h"
+
+#define ICON_N 200
+
+static void bench_find_icon(void);
+static char *create_theme(void);
+static void create_theme_dir(const char *base, const char *dir);
+
+static const char *theme_dirs[]={"16x16/apps", "24x24/apps", "32x32/apps",
+    "48x48/apps", "64x64/apps", "128x128/apps", "scalable/apps", NULL};
+
+int main(void)
+{
+    bench_find_icon();
+
+    return 0;
+}
+
+/* 在合成的圖標主題中查找圖標，HOME和XDG_DATA_DIRS均指向臨時目錄，以免受系統
+ * 已安裝主題的影響 */
+static void bench_find_icon(void)
+{
+    char *base=create_theme(), *share=copy_strings(base, "/share", NULL),
+         *cmd=copy_strings("rm -rf ", base, NULL);
+
+    setenv("HOME", base, 1);
+    setenv("XDG_DATA_DIRS", share, 1);
+    BENCH("find_icon_exact_size", 1000,
+        char *fn=find_icon("app150", 48, 1, "bench", "apps");
+        bench_sink+=(uintptr_t)fn;
+        Free(fn));
+    BENCH("find_icon_closest_size", 1000,
+        char *fn=find_icon("app150", 40, 1, "bench", "apps");
+        bench_sink+=(uintptr_t)fn;
+        Free(fn));
+    if(system(cmd) != 0)
+        perror(cmd);
+    vfree(base, share, cmd);
+}
+
+static char *create_theme(void)
+{
+    char d[]="/tmp/bimageXXXXXX", *base=NULL, *icons=NULL;
+
+    if(!mkdtemp(d))
+        exit_with_perror("mkdtemp");
+    base=copy_string(d);
+    icons=copy_strings(base, "/share/icons/bench", NULL);
+    if(!make_dirs(icons))
+        exit_with_perror(icons);
+
+    char *index=copy_strings(icons, "/index.theme", NULL);
+    FILE *fp=fopen(index, "w");
+    if(!fp)
+        exit_with_perror(index);
+    fprintf(fp, "[Icon Theme]\nName=bench\nDirectories=");
+    for(const char **p=theme_dirs; *p; p++)
+        fprintf(fp, "%s%s", *p, p[1] ? "," : "\n");
+    for(const char **p=theme_dirs; *p; p++)
+    {
+        if(strncmp(*p, "scalable", 8) == 0)
+            fprintf(fp, "\n[%s]\nSize=48\nMinSize=16\nMaxSize=512\n"
+                "Context=Applications\nType=Scalable\n", *p);
+        else
+            fprintf(fp, "\n[%s]\nSize=%d\nContext=Applications\nType=Fixed\n",
+                *p, atoi(*p));
+        create_theme_dir(icons, *p);
+    }
+    fclose(fp);
+    vfree(icons, index);
+
+    return base;
+}
+
+static void create_theme_dir(const char *base, const char *dir)
+{
+    char name[FILENAME_MAX];
+
+    snprintf(name, sizeof(name), "%s/%s", base, dir);
+    if(!make_dirs(name))
+        exit_with_perror(name);
+    for(int i=0; i<ICON_N; i++)
+    {
+        snprintf(name, sizeof(name), "%s/%s/app%d.%s", base, dir, i,
+            strncmp(dir, "scalable", 8) ? "png" : "svg");
+        FILE *fp=fopen(name, "w");
+        if(fp)
+            fclose(fp);
+    }
+}
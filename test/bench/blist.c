@@ -0,0 +1,71 @@
+/* *************************************************************************
+ *     blist.c：對list模塊進行微基準測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L // 爲了使用clock_gettime
+
+#include "../../src/list.c"
+#include "../../src/misc.h"
+#include "bench.h"
+
+#define NODE_N 1000
+
+typedef struct
+{
+    int n;
+    List list;
+} Node;
+
+static void bench_traverse(Node *head);
+static void bench_bulk_move(Node *head);
+static void bench_add_del(Node *head);
+
+int main(void)
+{
+    Node head, *nodes=Malloc(NODE_N*sizeof(Node));
+
+    LIST_INIT(&head);
+    for(int i=0; i<NODE_N; i++)
+        nodes[i].n=i, LIST_ADD_TAIL(nodes+i, &head);
+
+    bench_traverse(&head);
+    bench_bulk_move(&head);
+    bench_add_del(&head);
+    Free(nodes);
+
+    return 0;
+}
+
+static void bench_traverse(Node *head)
+{
+    BENCH("list_traverse_1000", 10000,
+        LIST_FOR_EACH(Node, p, head) bench_sink+=p->n);
+    BENCH("list_count_nodes_1000", 10000,
+        bench_sink+=list_count_nodes(&head->list));
+}
+
+/* 反復把前半部分節點整體移到鏈表尾部，前後兩半節點數相同 */
+static void bench_bulk_move(Node *head)
+{
+    List *first=head->list.next, *last=first;
+    for(int i=1; i<NODE_N/2; i++)
+        last=last->next;
+
+    BENCH("list_bulk_move", 1000000,
+        list_bulk_move(head->list.prev, first, last);
+        last=first->prev; first=head->list.next);
+}
+
+static void bench_add_del(Node *head)
+{
+    Node node={0};
+    BENCH("list_add_del", 1000000,
+        LIST_ADD(&node, head); LIST_DEL(&node));
+}
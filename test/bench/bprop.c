@@ -0,0 +1,63 @@
+/* *************************************************************************
+ *     bprop.c：對prop模塊進行微基準測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L // 爲了使用clock_gettime
+
+#include "../../src/prop.c"
+#include "bench.h"
+
+#define ITEM_N 1024
+
+static void bench_convert_type(void);
+static void bench_change_prop(void);
+
+int main(void)
+{
+    bench_convert_type();
+    bench_change_prop();
+
+    return 0;
+}
+
+static void bench_convert_type(void)
+{
+    long src[ITEM_N];
+    uint32_t dst[ITEM_N];
+
+    for(size_t i=0; i<ITEM_N; i++)
+        src[i]=i*0x01010101L;
+    BENCH("convert_type_long_to_card32_1024", 10000,
+        for(size_t i=0; i<ITEM_N; i++)
+            convert_type((unsigned char *)(dst+i), sizeof(uint32_t),
+                (unsigned char *)(src+i), sizeof(long));
+        bench_sink+=dst[ITEM_N-1]);
+}
+
+/* 需要X服務器，無法連接時不輸出此項結果。只測量客戶端編碼及緩衝的開銷 */
+static void bench_change_prop(void)
+{
+    if(!(xinfo.display=XOpenDisplay(NULL)))
+        return;
+
+    long data[ITEM_N];
+    xinfo.screen=DefaultScreen(xinfo.display);
+    xinfo.root_win=RootWindow(xinfo.display, xinfo.screen);
+    Window win=XCreateSimpleWindow(xinfo.display, xinfo.root_win, 0, 0, 1, 1, 0, 0, 0);
+    Atom prop=XInternAtom(xinfo.display, "GWM_BENCH_PROP", False);
+
+    for(size_t i=0; i<ITEM_N; i++)
+        data[i]=i;
+    BENCH("change_prop_cardinal_1024", 1000,
+        change_prop(win, prop, XA_CARDINAL, 32, PropModeReplace,
+            (unsigned char *)data, sizeof(long), ITEM_N));
+    XDestroyWindow(xinfo.display, win);
+    XCloseDisplay(xinfo.display);
+}
@@ -0,0 +1,462 @@
+/* *************************************************************************
+ *     elatency.c：在真實X服務器上測量窗口管理操作的端到端延遲。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+/* 本程序扮演N個合成客戶（每個客戶使用獨立的X連接，可設置標題、圖標、尺寸特性
+ * 和臨時窗口關係），在已運行gwm的顯示器上測量：
+ *     map：從映射請求到窗口可見（即框架已映射）的延遲；
+ *     relayout_add/relayout_remove：TILE模式下增刪窗口後布局穩定所需時間；
+ *     desktop_switch：切換虛擬桌面所需時間；
+ *     focus：請求激活窗口到窗口獲得焦點的延遲。
+ * 若以-p和-l指定gwm的進程號及其標準錯誤的日誌文件，且gwm開啓了
+ * cfg->event_stats，則還會通過SIGUSR1讀取每類操作期間gwm發出的X請求數。
+ * 結果以JSON對象逐行輸出；以-b指定基準結果時，任一操作的平均耗時超過基準的
+ * -r倍即以非零狀態退出，以便把關性能退化。通常由run.sh調用。 */
+
+#define _POSIX_C_SOURCE 200809L // 爲了使用clock_gettime、kill和getopt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+
+#define SETTLE_MS 100 // 在此時間內沒有ConfigureNotify事件即視爲布局已穩定
+#define TIMEOUT_MS 5000 // 等待單個操作完成的最長時間
+#define DUMP_WAIT_MS 200 // 發送SIGUSR1後等待gwm輸出統計結果的時間
+#define FOCUS_TIMES 20 // 測量焦點切換的次數
+#define SWITCH_TIMES 5 // 測量桌面切換的次數
+#define BASELINE_MAX 64 // 基準結果的最大條目數
+#define ICON_SIZE 32 // 合成圖標的邊長
+
+typedef struct // 合成客戶
+{
+    Display *display;
+    Window win;
+} Eclient;
+
+typedef struct // 某類操作的耗時樣本
+{
+    double sum, max;
+    size_t n;
+} Sample;
+
+typedef struct // 基準結果的一個條目
+{
+    size_t n;
+    char op[32];
+    double mean_ms;
+} Baseline;
+
+typedef struct // 命令行選項
+{
+    size_t n; // 合成客戶數
+    const char *title; // 窗口標題前綴
+    bool icon; // 是否設置_NET_WM_ICON
+    bool size_hints; // 是否設置WM_NORMAL_HINTS
+    size_t transient; // 每隔多少個窗口設置一個臨時窗口，0表示不設置
+    pid_t gwm_pid; // gwm的進程號，0表示不統計X請求數
+    const char *gwm_log; // gwm標準錯誤的日誌文件
+    const char *baseline; // 基準結果文件
+    double ratio; // 允許的退化倍數
+} Options;
+
+static Options opts={.n=10, .title="elatency", .ratio=1.5};
+static Display *ctrl=NULL; // 用於發送EWMH消息的控制連接
+static Eclient *clients=NULL;
+static size_t nclients=0;
+static Baseline baselines[BASELINE_MAX];
+static size_t nbaselines=0;
+static long log_offset=0; // gwm日誌已讀取的位置
+static bool regressed=false;
+
+static void parse_options(int argc, char *argv[]);
+static double now_ms(void);
+static void *Malloc(size_t size);
+static Eclient create_client(size_t i);
+static void set_icon(Eclient *c);
+static void set_size_hints(Eclient *c);
+static void destroy_client(Eclient *c);
+static bool wait_viewable(Eclient *c, bool viewable);
+static bool wait_focus_in(Eclient *c);
+static double wait_settle(void);
+static void drain_events(void);
+static void send_wm_message(Window win, const char *type, long l0, long l1);
+static long read_requests(void);
+static void load_baselines(void);
+static void add_sample(Sample *s, double ms);
+static void report(const char *op, const Sample *s, long requests);
+static void measure_map(void);
+static void measure_relayout(void);
+static void measure_desktop_switch(void);
+static void measure_focus(void);
+
+int main(int argc, char *argv[])
+{
+    parse_options(argc, argv);
+    if(!(ctrl=XOpenDisplay(NULL)))
+        fprintf(stderr, "cannot open display\n"), exit(EXIT_FAILURE);
+    load_baselines();
+    clients=Malloc(opts.n*sizeof(Eclient));
+    read_requests(); // 清空此前的統計
+
+    measure_map();
+    measure_relayout();
+    measure_desktop_switch();
+    measure_focus();
+
+    for(size_t i=0; i<nclients; i++)
+        destroy_client(clients+i);
+    free(clients);
+    XCloseDisplay(ctrl);
+
+    return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static void parse_options(int argc, char *argv[])
+{
+    for(int c; (c=getopt(argc, argv, "n:T:iHt:p:l:b:r:")) != -1;)
+    {
+        switch(c)
+        {
+            case 'n': opts.n=strtoul(optarg, NULL, 10); break;
+            case 'T': opts.title=optarg; break;
+            case 'i': opts.icon=true; break;
+            case 'H': opts.size_hints=true; break;
+            case 't': opts.transient=strtoul(optarg, NULL, 10); break;
+            case 'p': opts.gwm_pid=strtol(optarg, NULL, 10); break;
+            case 'l': opts.gwm_log=optarg; break;
+            case 'b': opts.baseline=optarg; break;
+            case 'r': opts.ratio=strtod(optarg, NULL); break;
+            default:
+                fprintf(stderr, "usage: %s [-n clients] [-T title] [-i] [-H] "
+                    "[-t transient_every] [-p gwm_pid -l gwm_log] "
+                    "[-b baseline -r ratio]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+    if(opts.n == 0)
+        opts.n=1;
+}
+
+static double now_ms(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec*1e3+t.tv_nsec/1e6;
+}
+
+static void *Malloc(size_t size)
+{
+    void *p=malloc(size);
+    if(!p)
+        perror("malloc"), exit(EXIT_FAILURE);
+    return p;
+}
+
+static Eclient create_client(size_t i)
+{
+    Eclient c={XOpenDisplay(NULL), None};
+    if(!c.display)
+        fprintf(stderr, "cannot open display for client %zu\n", i), exit(EXIT_FAILURE);
+
+    char title[64];
+    Display *d=c.display;
+    XWMHints hints={.flags=InputHint, .input=True};
+
+    c.win=XCreateSimpleWindow(d, DefaultRootWindow(d), 0, 0, 200, 150, 0, 0,
+        WhitePixel(d, DefaultScreen(d)));
+    snprintf(title, sizeof(title), "%s %zu", opts.title, i);
+    XStoreName(d, c.win, title);
+    XChangeProperty(d, c.win, XInternAtom(d, "_NET_WM_NAME", False),
+        XInternAtom(d, "UTF8_STRING", False), 8, PropModeReplace,
+        (unsigned char *)title, strlen(title));
+    XSetWMHints(d, c.win, &hints);
+    if(opts.icon)
+        set_icon(&c);
+    if(opts.size_hints)
+        set_size_hints(&c);
+    if(opts.transient && i && i%opts.transient==0)
+        XSetTransientForHint(d, c.win, clients[i-1].win);
+    XSelectInput(d, c.win, StructureNotifyMask|FocusChangeMask);
+
+    return c;
+}
+
+/* 設置兩個尺寸的圖標，以便測試gwm按尺寸選取圖標的開銷 */
+static void set_icon(Eclient *c)
+{
+    size_t n=2+16*16+2+ICON_SIZE*ICON_SIZE, i=0;
+    long *data=Malloc(n*sizeof(long));
+
+    for(int size=16; size<=ICON_SIZE; size*=2)
+    {
+        data[i++]=size, data[i++]=size;
+        for(int j=0; j<size*size; j++)
+            data[i++]=0xff000000UL|(j*0x010203UL&0xffffff);
+    }
+    XChangeProperty(c->display, c->win, XInternAtom(c->display, "_NET_WM_ICON", False),
+        XA_CARDINAL, 32, PropModeReplace, (unsigned char *)data, n);
+    free(data);
+}
+
+static void set_size_hints(Eclient *c)
+{
+    XSizeHints *hints=XAllocSizeHints();
+    if(!hints)
+        return;
+    hints->flags=PMinSize|PResizeInc|PBaseSize;
+    hints->min_width=hints->min_height=50;
+    hints->width_inc=hints->height_inc=7;
+    hints->base_width=hints->base_height=10;
+    XSetWMNormalHints(c->display, c->win, hints);
+    XFree(hints);
+}
+
+static void destroy_client(Eclient *c)
+{
+    XDestroyWindow(c->display, c->win);
+    XCloseDisplay(c->display);
+}
+
+/* 窗口可見即表示gwm已爲其創建並映射框架 */
+static bool wait_viewable(Eclient *c, bool viewable)
+{
+    XWindowAttributes a;
+
+    for(double start=now_ms(); now_ms()-start < TIMEOUT_MS;)
+        if(XGetWindowAttributes(c->display, c->win, &a)
+            && (a.map_state==IsViewable) == viewable)
+            return true;
+    return false;
+}
+
+static bool wait_focus_in(Eclient *c)
+{
+    XEvent e;
+    struct pollfd fd={ConnectionNumber(c->display), POLLIN, 0};
+
+    for(double start=now_ms(), left=TIMEOUT_MS; left>0; left=TIMEOUT_MS-(now_ms()-start))
+    {
+        while(XPending(c->display))
+            if(XNextEvent(c->display, &e), e.type==FocusIn && e.xfocus.window==c->win)
+                return true;
+        poll(&fd, 1, left);
+    }
+    return false;
+}
+
+/* 等待所有客戶的ConfigureNotify事件平息，返回最後一個事件距開始時的毫秒數 */
+static double wait_settle(void)
+{
+    double start=now_ms(), last=start;
+    struct pollfd *fds=Malloc(nclients*sizeof(struct pollfd));
+    XEvent e;
+
+    for(size_t i=0; i<nclients; i++)
+        fds[i]=(struct pollfd){ConnectionNumber(clients[i].display), POLLIN, 0};
+    while(now_ms()-start < TIMEOUT_MS)
+    {
+        for(size_t i=0; i<nclients; i++)
+            while(XPending(clients[i].display))
+                if(XNextEvent(clients[i].display, &e), e.type == ConfigureNotify)
+                    last=now_ms();
+        double left=SETTLE_MS-(now_ms()-last);
+        if(left <= 0 || poll(fds, nclients, left) == 0)
+            break;
+    }
+    free(fds);
+
+    return last-start;
+}
+
+static void drain_events(void)
+{
+    XEvent e;
+    for(size_t i=0; i<nclients; i++)
+        while(XPending(clients[i].display))
+            XNextEvent(clients[i].display, &e);
+}
+
+static void send_wm_message(Window win, const char *type, long l0, long l1)
+{
+    XEvent e={.xclient={.type=ClientMessage, .window=win, .format=32,
+        .message_type=XInternAtom(ctrl, type, False)}};
+
+    e.xclient.data.l[0]=l0, e.xclient.data.l[1]=l1;
+    XSendEvent(ctrl, DefaultRootWindow(ctrl), False,
+        SubstructureRedirectMask|SubstructureNotifyMask, &e);
+    XFlush(ctrl);
+}
+
+/* 讓gwm輸出並重置事件統計，匯總其中各類事件的X請求數。未指定gwm時返回-1 */
+static long read_requests(void)
+{
+    if(!opts.gwm_pid || !opts.gwm_log || kill(opts.gwm_pid, SIGUSR1))
+        return -1;
+    nanosleep(&(struct timespec){0, DUMP_WAIT_MS*1000000L}, NULL);
+
+    FILE *fp=fopen(opts.gwm_log, "r");
+    if(!fp)
+        return -1;
+
+    char line[BUFSIZ], name[32];
+    unsigned long count, avg, max, requests, flushes, win, serial;
+    long sum=0;
+
+    fseek(fp, log_offset, SEEK_SET);
+    while(fgets(line, sizeof(line), fp))
+        if(sscanf(line, "%31s %lu %lu %lu %lu %lu %lx %lu", name, &count, &avg,
+            &max, &requests, &flushes, &win, &serial)==8 && strcmp(name, "histogram"))
+            sum += requests;
+    log_offset=ftell(fp);
+    fclose(fp);
+
+    return sum;
+}
+
+static void load_baselines(void)
+{
+    if(!opts.baseline)
+        return;
+
+    FILE *fp=fopen(opts.baseline, "r");
+    if(!fp)
+        perror(opts.baseline), exit(EXIT_FAILURE);
+
+    char line[BUFSIZ];
+    Baseline *b=baselines;
+    while(nbaselines<BASELINE_MAX && fgets(line, sizeof(line), fp))
+        if(sscanf(line, "{\"n\":%zu,\"op\":\"%31[^\"]\",\"mean_ms\":%lf",
+            &b->n, b->op, &b->mean_ms) == 3)
+            b++, nbaselines++;
+    fclose(fp);
+}
+
+static void add_sample(Sample *s, double ms)
+{
+    s->sum += ms, s->n++;
+    if(ms > s->max)
+        s->max=ms;
+}
+
+/* 與基準相比，平均耗時超過其ratio倍且絕對差值超過1毫秒時視爲退化，以免被極小
+ * 的耗時的抖動誤判 */
+static void report(const char *op, const Sample *s, long requests)
+{
+    double mean = s->n ? s->sum/s->n : 0;
+
+    printf("{\"n\":%zu,\"op\":\"%s\",\"mean_ms\":%.3f,\"max_ms\":%.3f,"
+        "\"samples\":%zu,\"requests\":%ld}\n", opts.n, op, mean, s->max, s->n,
+        requests);
+    fflush(stdout);
+    for(size_t i=0; i<nbaselines; i++)
+    {
+        const Baseline *b=baselines+i;
+        if(b->n==opts.n && strcmp(b->op, op)==0
+            && mean>b->mean_ms*opts.ratio && mean-b->mean_ms>1)
+        {
+            fprintf(stderr, "regression: n=%zu %s %.3fms > %.3fms*%.2f\n",
+                opts.n, op, mean, b->mean_ms, opts.ratio);
+            regressed=true;
+        }
+    }
+}
+
+static void measure_map(void)
+{
+    Sample s={0};
+
+    for(size_t i=0; i<opts.n; i++)
+    {
+        clients[i]=create_client(i);
+        nclients++;
+        XSync(clients[i].display, False);
+        double start=now_ms();
+        XMapWindow(clients[i].display, clients[i].win);
+        if(wait_viewable(clients+i, true))
+            add_sample(&s, now_ms()-start);
+        drain_events();
+    }
+    wait_settle();
+    report("map", &s, read_requests());
+}
+
+/* 在已有n個窗口的基礎上增刪一個窗口，測量其餘窗口重新布局所需的時間 */
+static void measure_relayout(void)
+{
+    Sample add={0}, del={0};
+    Eclient extra=create_client(opts.n);
+
+    XSync(extra.display, False);
+    drain_events();
+    double start=now_ms();
+    XMapWindow(extra.display, extra.win);
+    XFlush(extra.display);
+    if(wait_viewable(&extra, true))
+    {
+        double mapped=now_ms()-start;
+        add_sample(&add, mapped+wait_settle());
+    }
+    report("relayout_add", &add, read_requests());
+
+    drain_events();
+    destroy_client(&extra);
+    add_sample(&del, wait_settle());
+    report("relayout_remove", &del, read_requests());
+}
+
+static void measure_desktop_switch(void)
+{
+    Sample s={0};
+    Eclient *first=clients, *last=clients+nclients-1;
+
+    for(int i=0; i<SWITCH_TIMES; i++)
+    {
+        double start=now_ms();
+        send_wm_message(DefaultRootWindow(ctrl), "_NET_CURRENT_DESKTOP", 1, CurrentTime);
+        if(wait_viewable(first, false) && wait_viewable(last, false))
+            add_sample(&s, now_ms()-start);
+
+        start=now_ms();
+        send_wm_message(DefaultRootWindow(ctrl), "_NET_CURRENT_DESKTOP", 0, CurrentTime);
+        if(wait_viewable(first, true) && wait_viewable(last, true))
+            add_sample(&s, now_ms()-start);
+    }
+    drain_events();
+    report("desktop_switch", &s, read_requests());
+}
+
+static void measure_focus(void)
+{
+    Sample s={0};
+
+    drain_events();
+    for(size_t i=0, prev=nclients; i<FOCUS_TIMES; i++)
+    {
+        size_t k=(i*7+1)%nclients;
+        if(k == prev)
+            continue;
+
+        double start=now_ms();
+        send_wm_message(clients[k].win, "_NET_ACTIVE_WINDOW", 2, CurrentTime);
+        if(wait_focus_in(clients+k))
+            add_sample(&s, now_ms()-start);
+        prev=k;
+        drain_events();
+    }
+    report("focus", &s, read_requests());
+}
@@ -0,0 +1,189 @@
+/* *************************************************************************
+ *     erepaint.c：在真實X服務器上測量合成器的重繪開銷。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+/* 本程序創建N個相互重疊的覆蓋重定向窗口（其中每隔若干個設置一個
+ * _NET_WM_WINDOW_OPACITY），然後逐幀在每個窗口中繪製一個移動的小方塊，以
+ * 產生與視頻、終端滾動相似的小面積損壞。以-p指定合成器的進程號，讀取其在
+ * 測量期間消耗的CPU時間，據此比較內置合成器與picom的xrender後端的重繪開銷。
+ * 結果以JSON對象輸出。通常由repaint.sh調用。 */
+
+#define _POSIX_C_SOURCE 200809L // 爲了使用clock_gettime、nanosleep和getopt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+
+#define WIN_W 400 // 窗口寬度
+#define WIN_H 300 // 窗口高度
+#define WIN_STEP 40 // 相鄰窗口的偏移量
+#define BOX_SIZE 64 // 每幀繪製的方塊邊長
+#define SETTLE_MS 500 // 映射窗口及結束繪製後等待合成器完成重繪的時間
+#define TRANS_OPACITY 0xc0000000UL // 半透明窗口的不透明度
+
+typedef struct // 命令行選項
+{
+    size_t n; // 窗口數
+    int frames; // 幀數
+    size_t trans; // 每隔多少個窗口設置一個半透明窗口，0表示不設置
+    long interval; // 幀間隔，單位爲毫秒
+    pid_t pid; // 合成器的進程號
+    const char *name; // 合成器名稱，僅用於輸出
+} Options;
+
+static Options opts={.n=8, .frames=300, .trans=2, .interval=5, .name="unknown"};
+
+static void parse_options(int argc, char *argv[]);
+static double now_ms(void);
+static void sleep_ms(long ms);
+static double get_cpu_ms(pid_t pid);
+static Window create_win(Display *d, size_t i);
+static void draw_frame(Display *d, GC gc, const Window *wins, int frame);
+static XPoint get_box_pos(size_t i, int frame);
+
+int main(int argc, char *argv[])
+{
+    parse_options(argc, argv);
+
+    Display *d=XOpenDisplay(NULL);
+    if(!d)
+        fprintf(stderr, "cannot open display\n"), exit(EXIT_FAILURE);
+
+    Window *wins=malloc(opts.n*sizeof(Window));
+    if(!wins)
+        perror("malloc"), exit(EXIT_FAILURE);
+    for(size_t i=0; i<opts.n; i++)
+        XMapWindow(d, wins[i]=create_win(d, i));
+    GC gc=XCreateGC(d, wins[0], 0, NULL);
+    XSync(d, False);
+    sleep_ms(SETTLE_MS);
+
+    double cpu=get_cpu_ms(opts.pid), start=now_ms();
+    for(int i=0; i<opts.frames; i++)
+        draw_frame(d, gc, wins, i), sleep_ms(opts.interval);
+    double wall=now_ms()-start;
+    sleep_ms(SETTLE_MS);
+    cpu=get_cpu_ms(opts.pid)-cpu;
+
+    printf("{\"compositor\":\"%s\",\"n\":%zu,\"frames\":%d,\"cpu_ms\":%.1f,"
+        "\"cpu_us_per_frame\":%.1f,\"wall_ms\":%.1f}\n", opts.name, opts.n,
+        opts.frames, cpu, cpu*1000/opts.frames, wall);
+
+    XFreeGC(d, gc);
+    for(size_t i=0; i<opts.n; i++)
+        XDestroyWindow(d, wins[i]);
+    free(wins);
+    XCloseDisplay(d);
+
+    return cpu<0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static void parse_options(int argc, char *argv[])
+{
+    for(int c; (c=getopt(argc, argv, "n:f:t:i:p:N:")) != -1;)
+    {
+        switch(c)
+        {
+            case 'n': opts.n=strtoul(optarg, NULL, 10); break;
+            case 'f': opts.frames=atoi(optarg); break;
+            case 't': opts.trans=strtoul(optarg, NULL, 10); break;
+            case 'i': opts.interval=strtol(optarg, NULL, 10); break;
+            case 'p': opts.pid=strtol(optarg, NULL, 10); break;
+            case 'N': opts.name=optarg; break;
+            default:
+                fprintf(stderr, "usage: %s -p compositor_pid [-N name] "
+                    "[-n windows] [-f frames] [-t translucent_every] "
+                    "[-i interval_ms]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+    if(!opts.pid)
+        fprintf(stderr, "%s: -p is required\n", argv[0]), exit(EXIT_FAILURE);
+    if(opts.n == 0)
+        opts.n=1;
+    if(opts.frames <= 0)
+        opts.frames=1;
+}
+
+static double now_ms(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec*1e3+t.tv_nsec/1e6;
+}
+
+static void sleep_ms(long ms)
+{
+    nanosleep(&(struct timespec){ms/1000, ms%1000*1000000L}, NULL);
+}
+
+/* 從/proc/<pid>/stat的第14、15個字段讀取用戶態和內核態CPU時間，失敗時返回-1 */
+static double get_cpu_ms(pid_t pid)
+{
+    char path[64], buf[BUFSIZ], *p;
+    unsigned long utime, stime;
+
+    snprintf(path, sizeof(path), "/proc/%ld/stat", (long)pid);
+    FILE *fp=fopen(path, "r");
+    if(!fp)
+        return -1;
+    size_t n=fread(buf, 1, sizeof(buf)-1, fp);
+    fclose(fp);
+    buf[n]='\0';
+
+    // 進程名可能含空格，故從最後一個右括號之後開始解析，此後第12、13個字段即是
+    if(!(p=strrchr(buf, ')')) || sscanf(p+1, " %*c %*d %*d %*d %*d %*d %*u "
+        "%*u %*u %*u %*u %lu %lu", &utime, &stime) != 2)
+        return -1;
+    return (utime+stime)*1000.0/sysconf(_SC_CLK_TCK);
+}
+
+static Window create_win(Display *d, size_t i)
+{
+    int s=DefaultScreen(d);
+    XSetWindowAttributes attr={.override_redirect=True,
+        .background_pixel=0x102030*(i%8+1)};
+    int x=i*WIN_STEP%(DisplayWidth(d, s)-WIN_W),
+        y=i*WIN_STEP%(DisplayHeight(d, s)-WIN_H);
+    Window win=XCreateWindow(d, DefaultRootWindow(d), x, y, WIN_W, WIN_H, 0,
+        CopyFromParent, InputOutput, CopyFromParent,
+        CWOverrideRedirect|CWBackPixel, &attr);
+
+    if(opts.trans && i%opts.trans==0)
+    {
+        unsigned long opacity=TRANS_OPACITY;
+        XChangeProperty(d, win, XInternAtom(d, "_NET_WM_WINDOW_OPACITY", False),
+            XA_CARDINAL, 32, PropModeReplace, (unsigned char *)&opacity, 1);
+    }
+    return win;
+}
+
+/* 每個窗口中擦除上一幀的方塊並在新位置繪製方塊 */
+static void draw_frame(Display *d, GC gc, const Window *wins, int frame)
+{
+    for(size_t i=0; i<opts.n; i++)
+    {
+        XPoint old=get_box_pos(i, frame-1), new=get_box_pos(i, frame);
+        XClearArea(d, wins[i], old.x, old.y, BOX_SIZE, BOX_SIZE, False);
+        XSetForeground(d, gc, 0xffffff^(0x102030*(i%8+1)));
+        XFillRectangle(d, wins[i], gc, new.x, new.y, BOX_SIZE, BOX_SIZE);
+    }
+    XSync(d, False);
+}
+
+static XPoint get_box_pos(size_t i, int frame)
+{
+    frame += opts.frames; // 使第0幀的上一幀亦非負
+    return (XPoint){(frame*7+i*13)%(WIN_W-BOX_SIZE), (frame*5+i*11)%(WIN_H-BOX_SIZE)};
+}
@@ -0,0 +1,75 @@
+#!/bin/sh
+
+# *************************************************************************
+#     repaint.sh：在Xvfb上比較內置合成器與picom的xrender後端的重繪開銷。
+#     版權 (C) 2025 gsm <406643764@qq.com>
+#     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+# GNU通用公共許可證重新發布、修改本程序。
+#     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+# 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+#     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+# <http://www.gnu.org/licenses/>。
+# *************************************************************************
+
+# 用法：repaint.sh 開啓內置合成器的gwm路徑 [未開啓內置合成器的gwm路徑]
+# 第一個gwm須以cfg->builtin_compositor=true的配置構建，此時測量gwm進程的CPU
+# 時間（其中亦含少量窗口管理工作）。給出第二個gwm且已安裝picom時，再以它配合
+# picom --backend xrender測量picom進程的CPU時間。結果以JSON數組寫入
+# repaint.json。可用WINDOWS、FRAMES和TRANS環境變量調整erepaint的參數。
+
+set -e
+
+if ! command -v Xvfb > /dev/null
+then
+    echo "找不到Xvfb，無法運行重繪開銷測試" >&2
+    exit 1
+fi
+
+dir=$(dirname "$0")
+builtin_gwm=${1:-$dir/../../src/gwm}
+plain_gwm=$2
+display=${E2E_DISPLAY:-:98}
+args="-n ${WINDOWS:-8} -f ${FRAMES:-300} -t ${TRANS:-2}"
+out=$(mktemp /tmp/gwm-repaint-XXXXXX.json)
+pids=
+
+Xvfb "$display" -screen 0 1920x1080x24 -nolisten tcp +extension Composite \
+    2> /dev/null &
+xvfb_pid=$!
+trap 'kill $pids $xvfb_pid 2> /dev/null; rm -f "$out"' EXIT
+sock=/tmp/.X11-unix/X${display#:}
+for i in $(seq 50)
+do
+    [ -S "$sock" ] && break
+    sleep 0.1
+done
+
+# 用法：run_session gwm路徑 名稱 [合成器命令]
+run_session()
+{
+    DISPLAY=$display "$1" 2> /dev/null &
+    gwm_pid=$!
+    pids="$gwm_pid"
+    sleep 1
+    pid=$gwm_pid
+    if [ -n "$3" ]
+    then
+        DISPLAY=$display $3 2> /dev/null &
+        pid=$!
+        pids="$pids $pid"
+        sleep 1
+    fi
+    DISPLAY=$display "$dir/erepaint" $args -p "$pid" -N "$2" >> "$out"
+    kill $pids
+    wait $pids 2> /dev/null || true
+    pids=
+}
+
+run_session "$builtin_gwm" builtin
+if [ -n "$plain_gwm" ] && command -v picom > /dev/null
+then
+    run_session "$plain_gwm" picom-xrender "picom --backend xrender --no-vsync"
+fi
+
+sed '1s/^/[\n/; $!s/$/,/; $s/$/\n]/' "$out" > repaint.json
+cat repaint.json
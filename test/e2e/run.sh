@@ -0,0 +1,58 @@
+#!/bin/sh
+
+# *************************************************************************
+#     run.sh：在Xvfb上啓動gwm，以不同數量的合成客戶運行elatency。
+#     版權 (C) 2025 gsm <406643764@qq.com>
+#     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+# GNU通用公共許可證重新發布、修改本程序。
+#     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+# 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+#     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+# <http://www.gnu.org/licenses/>。
+# *************************************************************************
+
+# 用法：run.sh [gwm路徑] [基準結果文件]
+# 結果以JSON數組寫入e2e.json。給出基準結果文件時，任一操作的平均耗時超過基準
+# 的RATIO倍（默認1.5）即以非零狀態退出。若要統計X請求數，須以開啓
+# cfg->event_stats的配置構建gwm。
+
+set -e
+
+if ! command -v Xvfb > /dev/null
+then
+    echo "找不到Xvfb，無法運行端到端延遲測試" >&2
+    exit 1
+fi
+
+dir=$(dirname "$0")
+gwm=${1:-$dir/../../src/gwm}
+baseline=$2
+ratio=${RATIO:-1.5}
+counts=${COUNTS:-"1 10 100 500"}
+display=${E2E_DISPLAY:-:99}
+log=$(mktemp /tmp/gwm-e2e-XXXXXX.log)
+out=$(mktemp /tmp/gwm-e2e-XXXXXX.json)
+
+# 每個合成客戶使用一個X連接，故需提高Xvfb的客戶數上限
+Xvfb "$display" -screen 0 1920x1080x24 -nolisten tcp -maxclients 1024 2> /dev/null &
+xvfb_pid=$!
+trap 'kill $gwm_pid $xvfb_pid 2> /dev/null; rm -f "$log" "$out"' EXIT
+sock=/tmp/.X11-unix/X${display#:}
+for i in $(seq 50)
+do
+    [ -S "$sock" ] && break
+    sleep 0.1
+done
+
+DISPLAY=$display "$gwm" 2> "$log" &
+gwm_pid=$!
+sleep 1
+
+for n in $counts
+do
+    DISPLAY=$display "$dir/elatency" -n "$n" -i -H -t 10 -p "$gwm_pid" \
+        -l "$log" ${baseline:+-b "$baseline" -r "$ratio"} >> "$out"
+done
+
+sed '1s/^/[\n/; $!s/$/,/; $s/$/\n]/' "$out" > e2e.json
+cat e2e.json
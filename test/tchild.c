@@ -0,0 +1,67 @@
+/* *************************************************************************
+ *     tchild.c：對child模塊進行單元測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include "../src/child.c"
+#include <assert.h>
+#include <errno.h>
+#include "../src/file.h"
+
+static void test_reap_children(void);
+static void test_reap_untracked_child(void);
+
+int main(void)
+{
+    init_child_reaper();
+    test_reap_children();
+    test_reap_untracked_child();
+    deinit_child_reaper();
+
+    return 0;
+}
+
+static void test_reap_children(void)
+{
+    if(!pidfd_supported) // 回收工作由SIGCHLD信號處理函數完成
+        return;
+
+    exec_cmd((char *const []){"true", NULL});
+    exec_cmd((char *const []){"true", NULL});
+    assert(get_child_count() == 2);
+
+    pid_t pids[]={children[0].pid, children[1].pid};
+    while(get_child_count())
+    {
+        size_t n=get_child_count();
+        struct pollfd fds[n];
+        set_child_pollfds(fds);
+        assert(poll(fds, n, -1) > 0);
+        reap_children(fds, n);
+    }
+    for(size_t i=0; i<ARRAY_NUM(pids); i++) // 已回收的子進程不再是殭屍進程
+        assert(waitpid(pids[i], NULL, WNOHANG)==-1 && errno==ECHILD);
+
+    exec_cmd((char *const []){"/nonexistent/gwm-test-cmd", NULL});
+    assert(get_child_count() == 0);
+}
+
+/* 沒有pidfd的子進程由SIGCHLD信號處理函數回收 */
+static void test_reap_untracked_child(void)
+{
+    pid_t pid=fork();
+    siginfo_t info;
+
+    assert(pid >= 0);
+    if(pid == 0)
+        _exit(0);
+    for(int i=0; i<1000 && !waitid(P_PID, pid, &info, WEXITED|WNOHANG|WNOWAIT); i++)
+        usleep(1000);
+    assert(waitpid(pid, NULL, WNOHANG)==-1 && errno==ECHILD);
+}
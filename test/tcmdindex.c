@@ -0,0 +1,108 @@
+/* *************************************************************************
+ *     tcmdindex.c：對cmdindex模塊進行單元測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include "../src/cmdindex.c"
+#include <assert.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+static void create_file(const char *dir, const char *name);
+static void remove_file(const char *dir, const char *name);
+static bool is_equal_completions(const char *prefix, size_t nmax, const char *expect[]);
+static void test_prefix_search(void);
+static void test_nmax(void);
+static void test_invalidation(void);
+
+static char dir1[]="/tmp/tcmdindex1XXXXXX", dir2[]="/tmp/tcmdindex2XXXXXX";
+
+int main(void)
+{
+    assert(mkdtemp(dir1) && mkdtemp(dir2));
+    create_file(dir1, "abc");
+    create_file(dir1, "abd");
+    create_file(dir1, "b");
+    create_file(dir2, "abc");
+    create_file(dir2, "ab");
+    char *subdir=copy_strings(dir1, "/abz", NULL);
+    assert(mkdir(subdir, 0700) == 0);
+    char *path=copy_strings(dir1, ":", dir2, NULL);
+    setenv("PATH", path, 1);
+
+    init_cmd_index();
+    test_prefix_search();
+    test_nmax();
+    test_invalidation();
+    deinit_cmd_index();
+
+    rmdir(subdir);
+    vfree(subdir, path);
+    remove_file(dir1, "abc"), remove_file(dir1, "abd"), remove_file(dir1, "b");
+    remove_file(dir2, "abc"), remove_file(dir2, "ab");
+    rmdir(dir1), rmdir(dir2);
+
+    return 0;
+}
+
+static void create_file(const char *dir, const char *name)
+{
+    char *fn=copy_strings(dir, "/", name, NULL);
+    FILE *fp=fopen(fn, "w");
+    assert(fp);
+    fclose(fp);
+    Free(fn);
+}
+
+static void remove_file(const char *dir, const char *name)
+{
+    char *fn=copy_strings(dir, "/", name, NULL);
+    remove(fn);
+    Free(fn);
+}
+
+// expect爲以NULL結尾的期望補全結果
+static bool is_equal_completions(const char *prefix, size_t nmax, const char *expect[])
+{
+    Strings *strs=get_cmd_completions(prefix, nmax);
+    size_t i=0;
+    bool result=true;
+
+    LIST_FOR_EACH(Strings, s, strs)
+        if(!expect[i] || strcmp(s->str, expect[i++]))
+            result=false;
+    result = result && !expect[i];
+    vfree_strings(strs);
+    Free(strs);
+
+    return result;
+}
+
+static void test_prefix_search(void)
+{
+    assert(is_equal_completions("ab", 10, (const char *[]){"ab", "abc", "abd", NULL}));
+    assert(is_equal_completions("abc", 10, (const char *[]){"abc", NULL}));
+    assert(is_equal_completions("b", 10, (const char *[]){"b", NULL}));
+    assert(is_equal_completions("c", 10, (const char *[]){NULL}));
+    assert(is_equal_completions("abz", 10, (const char *[]){NULL}));
+}
+
+static void test_nmax(void)
+{
+    assert(is_equal_completions("ab", 2, (const char *[]){"ab", "abc", NULL}));
+    assert(is_equal_completions("ab", 0, (const char *[]){NULL}));
+}
+
+static void test_invalidation(void)
+{
+    create_file(dir2, "abe");
+    assert(is_equal_completions("ab", 10, (const char *[]){"ab", "abc", "abd", "abe", NULL}));
+    remove_file(dir2, "abe");
+    assert(is_equal_completions("ab", 10, (const char *[]){"ab", "abc", "abd", NULL}));
+}
@@ -0,0 +1,71 @@
+/* *************************************************************************
+ *     tevstats.c：對evstats模塊進行單元測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L // 爲了使用open_memstream
+
+#include "../src/evstats.c"
+#include <assert.h>
+
+static void test_get_bucket_index(void);
+static void test_get_event_time(void);
+static void test_dump_event_stats(void);
+
+int main(void)
+{
+    test_get_bucket_index();
+    test_get_event_time();
+    test_dump_event_stats();
+
+    return 0;
+}
+
+static void test_get_bucket_index(void)
+{
+    assert(get_bucket_index(0) == 0);
+    assert(get_bucket_index(1) == 1);
+    assert(get_bucket_index(2)==2 && get_bucket_index(3)==2);
+    assert(get_bucket_index(1023) == 10);
+    assert(get_bucket_index(1024) == 11);
+    assert(get_bucket_index(~0UL) == EVENT_STATS_BUCKET_N-1);
+}
+
+static void test_get_event_time(void)
+{
+    XEvent e={0};
+    Time t=0;
+
+    e.type=ButtonPress, e.xbutton.time=1234;
+    assert(get_event_time(&e, &t) && t==1234);
+    e.type=PropertyNotify, e.xproperty.time=CurrentTime;
+    assert(!get_event_time(&e, &t));
+    e.type=Expose;
+    assert(!get_event_time(&e, &t));
+}
+
+static void test_dump_event_stats(void)
+{
+    char *buf=NULL;
+    size_t size=0;
+    FILE *fp=open_memstream(&buf, &size);
+
+    assert(fp);
+    event_stats[MapRequest]=(Event_stats){.count=2, .total_us=30, .max_us=20,
+        .requests=7, .flushes=1, .slowest_win=0x400001, .slowest_serial=9};
+    event_stats[MapRequest].hist[get_bucket_index(20)]=1;
+    dump_event_stats(fp);
+    fclose(fp);
+    assert(strstr(buf, "MapRequest") && strstr(buf, "400001"));
+    assert(!strstr(buf, "KeyPress"));
+    free(buf);
+
+    reset_event_stats();
+    assert(event_stats[MapRequest].count == 0);
+}
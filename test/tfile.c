@@ -0,0 +1,184 @@
+/* *************************************************************************
+ *     tfile.c：對file模塊進行單元測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include "../src/file.c"
+#include <assert.h>
+#include <time.h>
+#include <stdio.h>
+
+#define PATHOLOGICAL_LEN 20000
+
+static bool regcmp(const char *s, const char *regex);
+static void test_compile_pattern(void);
+static void test_exact(void);
+static void test_prefix_suffix(void);
+static void test_glob(void);
+static void test_alternatives(void);
+static void test_pathological(void);
+static void create_file(const char *dir, const char *name);
+static void test_get_files_in_paths(void);
+static bool is_equal_files(Strings *files, const char *expect[]);
+static void test_make_dirs(void);
+
+int main(void)
+{
+    test_compile_pattern();
+    test_exact();
+    test_prefix_suffix();
+    test_glob();
+    test_alternatives();
+    test_pathological();
+    test_get_files_in_paths();
+    test_make_dirs();
+
+    return 0;
+}
+
+static bool regcmp(const char *s, const char *regex)
+{
+    Pattern *pattern=compile_pattern(regex);
+    bool result=match_pattern(pattern, s);
+    free_pattern(pattern);
+    return result;
+}
+
+static void test_compile_pattern(void)
+{
+    Pattern *pattern=compile_pattern("abc|*.png|ab.*|a**.*b");
+
+    assert(pattern->n == 4);
+    assert(pattern->alts[0].kind==ALT_EXACT && !strcmp(pattern->alts[0].str, "abc"));
+    assert(pattern->alts[1].kind==ALT_SUFFIX && pattern->alts[1].len==4
+        && !strncmp(pattern->alts[1].str, ".png", 4));
+    assert(pattern->alts[2].kind==ALT_PREFIX && pattern->alts[2].len==2
+        && !strncmp(pattern->alts[2].str, "ab", 2));
+    assert(pattern->alts[3].kind==ALT_GLOB && !strcmp(pattern->alts[3].str, "a*b"));
+    free_pattern(pattern);
+}
+
+static void test_exact(void)
+{
+    assert(regcmp("abc", "abc"));
+    assert(regcmp("abc", "a.c"));
+    assert(!regcmp("abcd", "abc"));
+    assert(!regcmp("ab", "abc"));
+    assert(regcmp("", ""));
+}
+
+static void test_prefix_suffix(void)
+{
+    assert(regcmp("a.png", "*.png"));
+    assert(regcmp(".png", "*.png"));
+    assert(!regcmp("png", "*.png"));
+    assert(!regcmp("a.png.bak", "*.png"));
+    assert(regcmp("xterm", "xt.*"));
+    assert(regcmp("xt", "xt*"));
+    assert(!regcmp("x", "xt*"));
+    assert(regcmp("anything", "*"));
+    assert(regcmp("", ".*"));
+}
+
+static void test_glob(void)
+{
+    assert(regcmp("abcb", "a*b"));
+    assert(regcmp("ab", "a*b"));
+    assert(!regcmp("abc", "a*b"));
+    assert(regcmp("a1b2c", "*1*2*"));
+    assert(regcmp("axxbyyc", "a*b.*c"));
+    assert(!regcmp("axxbyy", "a*b*c"));
+}
+
+static void test_alternatives(void)
+{
+    const char *reg="*.png|*.jpg|*.svg|*.webp";
+
+    assert(regcmp("a.png", reg));
+    assert(regcmp("a.jpg", reg));
+    assert(regcmp("a.webp", reg));
+    assert(!regcmp("a.gif", reg));
+    assert(!regcmp("a.pngx", reg));
+}
+
+/* 遞歸回溯的實現對此類輸入的耗時隨*的數量指數增長 */
+static void test_pathological(void)
+{
+    char s[PATHOLOGICAL_LEN+1];
+    memset(s, 'a', PATHOLOGICAL_LEN), s[PATHOLOGICAL_LEN]='\0';
+
+    clock_t start=clock();
+    assert(!regcmp(s, "a*a*a*a*a*a*a*a*a*a*a*a*b"));
+    assert(regcmp(s, "a*a*a*a*a*a*a*a*a*a*a*a*a"));
+    assert(clock()-start < CLOCKS_PER_SEC);
+}
+
+static void create_file(const char *dir, const char *name)
+{
+    char *fn=copy_strings(dir, "/", name, NULL);
+    FILE *fp=fopen(fn, "w");
+    assert(fp);
+    fclose(fp);
+    Free(fn);
+}
+
+// expect爲以NULL結尾的期望結果，會釋放files
+static bool is_equal_files(Strings *files, const char *expect[])
+{
+    size_t i=0;
+    bool result=true;
+
+    LIST_FOR_EACH(Strings, s, files)
+        if(!expect[i] || strcmp(s->str, expect[i++]))
+            result=false;
+    result = result && !expect[i];
+    vfree_strings(files);
+    Free(files);
+
+    return result;
+}
+
+/* 目錄樹：d/b.png、d/x.txt、d/sub/a.png、d/sub/deep/c.png、d/sub/loop->d */
+static void test_get_files_in_paths(void)
+{
+    char d[]="/tmp/tfileXXXXXX";
+    assert(mkdtemp(d));
+    char *sub=copy_strings(d, "/sub", NULL), *deep=copy_strings(sub, "/deep", NULL),
+         *loop=copy_strings(sub, "/loop", NULL);
+    assert(mkdir(sub, 0700)==0 && mkdir(deep, 0700)==0 && symlink(d, loop)==0);
+    create_file(d, "b.png"), create_file(d, "x.txt");
+    create_file(sub, "a.png"), create_file(deep, "c.png");
+
+    assert(is_equal_files(get_files_in_paths(d, "*.png", false, -1),
+        (const char *[]){"a.png", "b.png", "c.png", NULL}));
+    assert(is_equal_files(get_files_in_paths(d, "*.png", false, 1),
+        (const char *[]){"a.png", "b.png", NULL}));
+    assert(is_equal_files(get_files_in_paths(d, "*.png", false, 0),
+        (const char *[]){"b.png", NULL}));
+    char *full=copy_strings(d, "/b.png", NULL);
+    assert(is_equal_files(get_files_in_paths(d, "b.*", true, -1),
+        (const char *[]){full, NULL}));
+
+    char *cmd=copy_strings("rm -rf ", d, NULL);
+    assert(system(cmd) == 0);
+    vfree(sub, deep, loop, full, cmd);
+}
+
+static void test_make_dirs(void)
+{
+    char d[]="/tmp/tfileXXXXXX";
+    assert(mkdtemp(d));
+    char *dirs=copy_strings(d, "/a/b/c", NULL), *cmd=copy_strings("rm -rf ", d, NULL);
+    struct stat st;
+
+    assert(make_dirs(dirs) && make_dirs(dirs));
+    assert(stat(dirs, &st)==0 && S_ISDIR(st.st_mode));
+    assert(system(cmd) == 0);
+    vfree(dirs, cmd);
+}
@@ -0,0 +1,91 @@
+/* *************************************************************************
+ *     tipc.c：對ipc模塊進行單元測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include "../src/ipc.c"
+#include <assert.h>
+
+static void test_split_ipc_cmd(void);
+static void test_parse_args(void);
+static void test_ipc_client(void);
+static const char *talk(int fd, const char *req);
+
+int main(void)
+{
+    test_split_ipc_cmd();
+    test_parse_args();
+    test_ipc_client();
+
+    return 0;
+}
+
+static void test_split_ipc_cmd(void)
+{
+    char s1[]="  exec  xterm -e top", s2[]="tile", s3[]="stack \t";
+    char *arg=NULL;
+
+    assert(strcmp(split_ipc_cmd(s1, &arg), "exec")==0 && strcmp(arg, "xterm -e top")==0);
+    assert(strcmp(split_ipc_cmd(s2, &arg), "tile")==0 && arg==NULL);
+    assert(strcmp(split_ipc_cmd(s3, &arg), "stack")==0 && arg==NULL);
+}
+
+static void test_parse_args(void)
+{
+    unsigned int n;
+    Window win;
+
+    assert(parse_desktop_n("0", &n) && n==0);
+    assert(parse_desktop_n("all", &n) && n==~0U);
+    assert(!parse_desktop_n("1x", &n) && !parse_desktop_n("", &n));
+    assert(!parse_desktop_n("99", &n));
+    assert(parse_win("0x400001", &win) && win==0x400001);
+    assert(!parse_win(NULL, &win) && !parse_win("abc", &win));
+}
+
+/* 以socketpair模擬客戶連接，只使用無需X服務器的命令 */
+static void test_ipc_client(void)
+{
+    int sv[2];
+
+    assert(socketpair(AF_UNIX, SOCK_STREAM|SOCK_NONBLOCK, 0, sv) == 0);
+    assert(add_ipc_client(sv[0]));
+    assert(strcmp(talk(sv[1], "nop\n"), "error: unknown command\n") == 0);
+    assert(strcmp(talk(sv[1], "get_trace\r\n\n"), "error: trace disabled\n") == 0);
+    assert(strcmp(talk(sv[1], "commit\n"), "error: not in batch\n") == 0);
+
+    // 不完整的行留待後續輸入
+    assert(strcmp(talk(sv[1], "begin\nno"), "ok\n") == 0);
+    assert(strcmp(talk(sv[1], "p\nfoo 1\n"), "") == 0);
+    assert(ipc_clients[0]->batch_n == 2);
+    assert(strcmp(talk(sv[1], "commit\n"), "error: unknown command\n"
+        "error: unknown command\nok\n") == 0);
+    assert(!ipc_clients[0]->in_batch && ipc_clients[0]->batch_n==0);
+
+    char line[IPC_LINE_MAX+1];
+    memset(line, 'x', IPC_LINE_MAX);
+    line[IPC_LINE_MAX]='\0';
+    assert(strcmp(talk(sv[1], line), "error: line too long\n") == 0);
+    assert(nipc_clients == 0);
+
+    close(sv[1]);
+}
+
+/* 把請求寫入套接字，讓ipc模塊處理，再讀回答復 */
+static const char *talk(int fd, const char *req)
+{
+    static char buf[BUFSIZ];
+    struct pollfd fds[2]={{listen_fd, 0, 0}, {ipc_clients[0]->fd, POLLIN, POLLIN}};
+
+    assert(write(fd, req, strlen(req)) == (ssize_t)strlen(req));
+    handle_ipc_events(fds, 2);
+    ssize_t n=read(fd, buf, sizeof(buf)-1);
+    buf[n>0 ? n : 0]='\0';
+    return buf;
+}
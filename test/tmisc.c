@@ -9,9 +9,9 @@
  * <http://www.gnu.org/licenses/>。
  * ************************************************************************/
 
+#include "../src/misc.c"
 #include <stdlib.h>
 #include <assert.h>
-#include "../src/misc.c"
 
 static void test_MIN(void);
 static void test_MAX(void);
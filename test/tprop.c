@@ -264,7 +264,8 @@ static void test_gwm_prop(void)
     set_gwm_layout(1);
     assert(get_gwm_layout() == 1);
 
-    request_layout_update();
+    // gwm內部已不再經由此特性請求更新布局，但仍響應外部程序的寫入
+    replace_cardinal_prop(xinfo.root_win, gwm_atoms[GWM_UPDATE_LAYOUT], 1);
     assert(get_cardinal_prop(xinfo.root_win, gwm_atoms[GWM_UPDATE_LAYOUT], -1) == 1);
 
     set_main_color_name("test");
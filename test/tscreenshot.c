@@ -0,0 +1,67 @@
+/* *************************************************************************
+ *     tscreenshot.c：對screenshot模塊進行單元測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include "../src/screenshot.c"
+#include <assert.h>
+
+#define W 5
+#define H 3
+
+static void test_get_mask_shift(void);
+static void test_save_png(void);
+
+int main(void)
+{
+    test_get_mask_shift();
+    test_save_png();
+
+    return 0;
+}
+
+static void test_get_mask_shift(void)
+{
+    assert(get_mask_shift(0xff0000) == 16);
+    assert(get_mask_shift(0xf800) == 11);
+    assert(get_mask_shift(0x1f) == 0);
+    assert(get_mask_shift(0) == 0);
+}
+
+/* 經工作線程寫入PNG文件後，通過管道取回任務，再讀回文件核對像素 */
+static void test_save_png(void)
+{
+    char name[]="/tmp/tscreenshotXXXXXX";
+    int fd=mkstemp(name);
+    assert(fd>=0 && pipe2(notify_fds, O_CLOEXEC)==0);
+    close(fd);
+
+    Screenshot *s=Malloc(sizeof(Screenshot)), *r=NULL;
+    *s=(Screenshot){Malloc(W*H*sizeof(DATA32)), W, H, copy_string(name), false};
+    for(int i=0; i<W*H; i++)
+        s->data[i]=0xff000000|(i*10<<16)|(i*5<<8)|i;
+
+    pthread_t tid;
+    assert(pthread_create(&tid, NULL, save_png, s) == 0);
+    assert(read(notify_fds[0], &r, sizeof(r))==sizeof(r) && r==s && s->ok);
+    pthread_join(tid, NULL);
+
+    png_image image={.version=PNG_IMAGE_VERSION};
+    unsigned char buf[W*H*3];
+    assert(png_image_begin_read_from_file(&image, name));
+    assert(image.width==W && image.height==H);
+    image.format=PNG_FORMAT_RGB;
+    assert(png_image_finish_read(&image, NULL, buf, 0, NULL));
+    for(int i=0; i<W*H; i++)
+        assert(buf[3*i]==i*10 && buf[3*i+1]==i*5 && buf[3*i+2]==i);
+
+    remove(name);
+    vfree(s->data, s->filename, s);
+    close(notify_fds[0]), close(notify_fds[1]);
+}
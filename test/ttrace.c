@@ -0,0 +1,102 @@
+/* *************************************************************************
+ *     ttrace.c：對trace模塊進行單元測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L // 爲了使用open_memstream
+
+#include "../src/trace.c"
+#include <assert.h>
+#include <string.h>
+
+static char *dump_to_string(void);
+static size_t count_substr(const char *s, const char *sub);
+static void test_spans(void);
+static void test_wrap_around(void);
+static void test_write_trace_file(void);
+
+int main(void)
+{
+    cfg=Malloc(sizeof(Config));
+    cfg->trace_path="/tmp/ttrace.json";
+
+    init_trace();
+    assert(trace_enabled);
+    test_spans();
+    test_wrap_around();
+    test_write_trace_file();
+    deinit_trace();
+    assert(!trace_enabled);
+
+    remove(cfg->trace_path);
+    Free(cfg);
+
+    return 0;
+}
+
+static char *dump_to_string(void)
+{
+    char *buf=NULL;
+    size_t size=0;
+    FILE *fp=open_memstream(&buf, &size);
+
+    assert(fp);
+    dump_trace(fp);
+    fclose(fp);
+
+    return buf;
+}
+
+static size_t count_substr(const char *s, const char *sub)
+{
+    size_t n=0;
+    for(const char *p=s; (p=strstr(p, sub)); p++)
+        n++;
+    return n;
+}
+
+static void test_spans(void)
+{
+    set_trace_serial(42);
+    TRACE_BEGIN("add_client", 0x400001);
+    TRACE_BEGIN("focus_client", 0x400001);
+    TRACE_END("focus_client", 0x400001);
+    TRACE_END("add_client", 0x400001);
+
+    char *s=dump_to_string();
+    assert(strncmp(s, "{\"traceEvents\":[", 16) == 0);
+    assert(count_substr(s, "\"ph\":\"B\"")==2 && count_substr(s, "\"ph\":\"E\"")==2);
+    assert(count_substr(s, "\"win\":\"0x400001\",\"serial\":42") == 4);
+    assert(strstr(s, "\"name\":\"add_client\"") < strstr(s, "\"name\":\"focus_client\""));
+    free(s);
+}
+
+static void test_wrap_around(void)
+{
+    for(size_t i=0; i<TRACE_RING_SIZE; i++)
+        TRACE_BEGIN("update_layout", None);
+
+    char *s=dump_to_string();
+    assert(count_substr(s, "\"name\":") == TRACE_RING_SIZE);
+    assert(!strstr(s, "add_client"));
+    free(s);
+}
+
+static void test_write_trace_file(void)
+{
+    kill(getpid(), SIGUSR2);
+    handle_trace_request();
+
+    FILE *fp=fopen(cfg->trace_path, "r");
+    assert(fp);
+    char buf[32]={0};
+    assert(fread(buf, 1, 16, fp) == 16);
+    assert(strcmp(buf, "{\"traceEvents\":[") == 0);
+    fclose(fp);
+}
@@ -0,0 +1,144 @@
+/* *************************************************************************
+ *     twallpaper.c：對wallpaper模塊進行單元測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#include "../src/wallpaper.c"
+#include <assert.h>
+#include <limits.h>
+
+#define W 4
+#define H 2
+
+static void test_scale_argb(void);
+static void test_decode_in_worker(void);
+static void test_wallpaper_cache(void);
+static void test_evict_wallpaper_cache(void);
+
+int main(void)
+{
+    cfg=Malloc(sizeof(Config));
+    cfg->wallpaper_cache_max=INT_MAX; // 以免刪除/tmp下的其他文件
+
+    test_scale_argb();
+    test_decode_in_worker();
+    test_wallpaper_cache();
+    test_evict_wallpaper_cache();
+
+    Free(cfg);
+    return 0;
+}
+
+static void test_scale_argb(void)
+{
+    DATA32 src[W*H]={0xff000000, 0xff0000ff, 0xffff0000, 0xffff0000,
+        0xff000000, 0xff0000ff, 0xff00ff00, 0xff00ff00}, *dst=NULL;
+
+    // 縮小時取平均值
+    assert((dst=scale_argb(src, W, H, 2, 1)));
+    assert(dst[0]==0xff00007f && dst[1]==0xff7f7f00);
+    free(dst);
+
+    // 放大時取最近的像素
+    assert((dst=scale_argb(src, W, H, W*2, H)));
+    assert(dst[0]==src[0] && dst[3]==src[1] && dst[W*2+7]==src[W+3]);
+    free(dst);
+}
+
+/* 經工作線程解碼PNG文件後，通過管道取回任務，再核對像素 */
+static void test_decode_in_worker(void)
+{
+    char name[]="/tmp/twallpaperXXXXXX";
+    int fd=mkstemp(name);
+    assert(fd>=0 && pipe2(notify_fds, O_CLOEXEC)==0);
+    close(fd);
+
+    unsigned char rgb[W*H*3];
+    for(int i=0; i<W*H; i++)
+        rgb[3*i]=i*10, rgb[3*i+1]=i*5, rgb[3*i+2]=i;
+    png_image image={.version=PNG_IMAGE_VERSION, .width=W, .height=H,
+        .format=PNG_FORMAT_RGB};
+    assert(png_image_write_to_file(&image, name, 0, rgb, 0, NULL));
+
+    Wallpaper_job *job=Malloc(sizeof(Wallpaper_job));
+    *job=(Wallpaper_job){copy_string(name), NULL, 0, W, H, 24, NULL, false, 0};
+    pthread_t tid;
+    assert(pthread_create(&tid, NULL, decode_in_worker, job) == 0);
+    assert(read_wallpaper_job()==job && job->data);
+    pthread_join(tid, NULL);
+    for(int i=0; i<W*H; i++)
+        assert(job->data[i] == (DATA32)(0xff000000|(i*10<<16)|(i*5<<8)|i));
+
+    // 不支持的格式留給事件線程解碼
+    FILE *fp=fopen(name, "w");
+    assert(fp && fputs("<svg/>", fp)>=0 && fclose(fp)==0);
+    Free(job->data);
+    decode_wallpaper(job);
+    assert(job->data == NULL);
+
+    free_wallpaper_job(job);
+    remove(name);
+    close(notify_fds[0]), close(notify_fds[1]);
+}
+
+static void test_wallpaper_cache(void)
+{
+    char name[]="/tmp/twallpaperXXXXXX";
+    int fd=mkstemp(name);
+    assert(fd >= 0);
+    close(fd);
+
+    DATA32 data[W*H];
+    for(int i=0; i<W*H; i++)
+        data[i]=0xff000000|i;
+    save_wallpaper_cache(name, 42, W, H, data);
+
+    Wallpaper_job job={NULL, name, 42, W, H, 24, NULL, false, 0};
+    assert(read_wallpaper_cache(&job) && memcmp(job.data, data, sizeof(data))==0);
+    Free(job.data);
+
+    // 壁紙文件已修改或屏幕尺寸已變化時緩存失效
+    job.mtime=43;
+    assert(!read_wallpaper_cache(&job) && job.data==NULL);
+    job.mtime=42, job.w=W/2;
+    assert(!read_wallpaper_cache(&job) && job.data==NULL);
+
+    remove(name);
+}
+
+/* 超出上限時刪除修改時間最早的緩存文件，並忽略非緩存文件 */
+static void test_evict_wallpaper_cache(void)
+{
+    char dir[]="/tmp/twallpaperXXXXXX", name[FILENAME_MAX];
+    const char *names[]={"wallpaper-1.raw", "wallpaper-2.raw", "other", "wallpaper-3.raw"};
+    DATA32 data[W*H]={0};
+
+    assert(mkdtemp(dir));
+    cfg->wallpaper_cache_max=2;
+    for(size_t i=0; i<ARRAY_NUM(names); i++)
+    {
+        snprintf(name, sizeof(name), "%s/%s", dir, names[i]);
+        FILE *fp=fopen(name, "w");
+        assert(fp && fclose(fp)==0);
+        struct timespec t[2]={{(time_t)i+1, 0}, {(time_t)i+1, 0}};
+        assert(utimensat(AT_FDCWD, name, t, 0) == 0);
+    }
+
+    // 新寫入的緩存最新，故應刪除wallpaper-1.raw和wallpaper-2.raw
+    snprintf(name, sizeof(name), "%s/wallpaper-4.raw", dir);
+    save_wallpaper_cache(name, 0, W, H, data);
+    for(size_t i=0; i<ARRAY_NUM(names); i++)
+    {
+        snprintf(name, sizeof(name), "%s/%s", dir, names[i]);
+        assert((access(name, F_OK)==0) == (i>=2));
+        remove(name);
+    }
+    snprintf(name, sizeof(name), "%s/wallpaper-4.raw", dir);
+    assert(remove(name)==0 && rmdir(dir)==0);
+}
@@ -0,0 +1,153 @@
+/* *************************************************************************
+ *     txres.c：對xres模塊進行單元測試。
+ *     版權 (C) 2025 gsm <406643764@qq.com>
+ *     本程序為自由軟件：你可以依據自由軟件基金會所發布的第三版或更高版本的
+ * GNU通用公共許可證重新發布、修改本程序。
+ *     雖然基于使用目的而發布本程序，但不負任何擔保責任，亦不包含適銷性或特
+ * 定目標之適用性的暗示性擔保。詳見GNU通用公共許可證。
+ *     你應該已經收到一份附隨此程序的GNU通用公共許可證副本。否則，請參閱
+ * <http://www.gnu.org/licenses/>。
+ * ************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L // 爲了使用open_memstream
+
+#include "../src/xres.c"
+#include <assert.h>
+#include "../src/color.h"
+#include "../src/config.h"
+#include "../src/font.h"
+#include "../src/widget.h"
+
+#define CYCLE_N 1000 // 創建構件、繪製文字、刪除構件的循環次數
+
+static void test_reg_unreg(void);
+static void test_many(void);
+static void test_no_growth_after_cycles(void);
+static bool init_gui_for_test(void);
+static void cycle_widget(void);
+static void test_dump_xres(void);
+
+int main(void)
+{
+    test_reg_unreg();
+    test_many();
+    if(init_gui_for_test()) // 沒有X服務器時只測試登記表本身
+    {
+        test_no_growth_after_cycles();
+        close_fonts();
+        free_depth_gcs();
+        XCloseDisplay(xinfo.display);
+        Free(cfg);
+    }
+    test_dump_xres();
+    free_xres_table();
+
+    return 0;
+}
+
+static void test_reg_unreg(void)
+{
+    Xres_usage u;
+
+    reg_xres(XRES_PIXMAP, 0x200001, "wallpaper", 4096);
+    reg_xres(XRES_PIXMAP, 0x200001, "wallpaper", 4096); // 重復登記應被忽略
+    reg_xres(XRES_WINDOW, 0x200001, "widget", 0); // 不同類型的同號資源
+    reg_xres(XRES_GC, 0, "font", 0); // 無效資源應被忽略
+    get_xres_usage(&u);
+    assert(u.count[XRES_PIXMAP]==1 && u.bytes[XRES_PIXMAP]==4096);
+    assert(u.count[XRES_WINDOW]==1 && u.count[XRES_GC]==0);
+    assert(is_xres_registered(XRES_WINDOW, 0x200001));
+
+    unreg_xres(XRES_PIXMAP, 0x200001);
+    unreg_xres(XRES_PIXMAP, 0x200001);
+    get_xres_usage(&u);
+    assert(u.count[XRES_PIXMAP]==0 && u.bytes[XRES_PIXMAP]==0);
+    assert(!is_xres_registered(XRES_PIXMAP, 0x200001));
+    assert(is_xres_registered(XRES_WINDOW, 0x200001));
+    unreg_xres(XRES_WINDOW, 0x200001);
+}
+
+/* 大量登記後隔一刪一，以檢驗擴容及刪除後前移表項的正確性 */
+static void test_many(void)
+{
+    for(uintptr_t id=1; id<=4096; id++)
+        reg_xres(XRES_WINDOW, id<<21, "widget", 0);
+    for(uintptr_t id=1; id<=4096; id+=2)
+        unreg_xres(XRES_WINDOW, id<<21);
+    for(uintptr_t id=1; id<=4096; id++)
+        assert(is_xres_registered(XRES_WINDOW, id<<21) == !(id&1));
+    for(uintptr_t id=2; id<=4096; id+=2)
+        unreg_xres(XRES_WINDOW, id<<21);
+
+    Xres_usage u;
+    get_xres_usage(&u);
+    assert(u.count[XRES_WINDOW] == 0);
+}
+
+/* 反復創建構件、在其上繪製文字、再刪除構件後，資源存量應與首次循環後相同。
+ * 首次循環會創建常駐的GC，故以其後的存量爲基准 */
+static void test_no_growth_after_cycles(void)
+{
+    Xres_usage base;
+
+    cycle_widget();
+    get_xres_usage(&base);
+    for(int i=0; i<CYCLE_N; i++)
+        cycle_widget();
+    XSync(xinfo.display, False);
+    assert(!is_xres_grown(&base));
+
+    // 漏刪的資源應能被發現
+    Widget *widget=widget_new(NULL, WIDGET_TYPE_BUTTON, UNUSED_WIDGET_ID, 0, 0, 1, 1);
+    assert(is_xres_grown(&base));
+    widget_del(widget);
+    assert(!is_xres_grown(&base));
+}
+
+static bool init_gui_for_test(void)
+{
+    XVisualInfo v;
+
+    if(!(xinfo.display=XOpenDisplay(NULL)))
+        return false;
+    xinfo.screen=DefaultScreen(xinfo.display);
+    xinfo.root_win=RootWindow(xinfo.display, xinfo.screen);
+    XMatchVisualInfo(xinfo.display, xinfo.screen, 32, TrueColor, &v);
+    xinfo.depth=v.depth, xinfo.visual=v.visual;
+    xinfo.colormap=XCreateColormap(xinfo.display, xinfo.root_win, v.visual, AllocNone);
+    config();
+    cfg->font_size=16;
+    load_fonts();
+    alloc_color(cfg->main_color_name);
+    return true;
+}
+
+static void cycle_widget(void)
+{
+    Widget *widget=widget_new(NULL, WIDGET_TYPE_BUTTON, UNUSED_WIDGET_ID, 0, 0, 64, 16);
+    Str_fmt fmt={0, 0, 64, 16, CENTER, true, true, get_widget_color(widget),
+        get_text_color(widget)};
+    Pixmap pixmap=create_pixmap(WIDGET_WIN(widget), 64, 16, xinfo.depth, "test");
+
+    draw_string(WIDGET_WIN(widget), "gwm", &fmt);
+    draw_string(pixmap, "gwm", &fmt);
+    free_pixmap(pixmap);
+    widget_del(widget);
+}
+
+static void test_dump_xres(void)
+{
+    char *buf=NULL;
+    size_t size=0;
+    FILE *fp=open_memstream(&buf, &size);
+
+    assert(fp);
+    reg_xres(XRES_PIXMAP, 0x200001, "wallpaper", 100);
+    reg_xres(XRES_PIXMAP, 0x200002, "wallpaper", 200);
+    dump_xres(fp);
+    fclose(fp);
+    char *p=strstr(buf, "wallpaper"); // 同一子系統的同類資源應匯總爲一行
+    assert(p && !strstr(p+1, "wallpaper"));
+    assert(strstr(p, "pixmap            2          300"));
+    free(buf);
+}